@@ -0,0 +1,183 @@
+//------------------------------------------------------------------------------
+
+// Служба будильников для set_alarm из раздела 6.4 на Timing_wheel
+
+// Будильники хранятся в иерархическом колесе с тиком options.tick, поэтому
+// постановка и отмена - O(1) даже при миллионах ожидающих. Отдельный поток
+// спит до ближайшего занятого тика колеса и передает обработчику пачку
+// созревших будильников. Срабатывания объединяются: все будильники одного
+// тика приходят одной пачкой, а options.slack разрешает задержать
+// пробуждение, чтобы захватить и близкие следующие. Будильник никогда не
+// срабатывает раньше своего времени. Обработчик вызывается вне блокировки
+// и не должен выбрасывать исключений
+
+//------------------------------------------------------------------------------
+
+#ifndef ALARM_SERVICE_HPP
+#define ALARM_SERVICE_HPP
+
+//------------------------------------------------------------------------------
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "Timing_wheel.hpp"
+
+//------------------------------------------------------------------------------
+
+namespace em {
+
+//------------------------------------------------------------------------------
+
+enum class Sound { Beep, Siren, Whistle };
+enum class Volume { Normal, Loud, Loud_plus_plus };
+
+struct Alarm {
+    std::chrono::steady_clock::time_point t;    // Когда
+    Sound s{Sound::Beep};                       // Какой звук
+    std::chrono::steady_clock::duration d{};    // Сколько звучать
+    Volume v{Volume::Normal};                   // Как громко
+};
+
+struct Alarm_options {
+    std::chrono::steady_clock::duration tick{std::chrono::milliseconds{1}};
+    std::chrono::steady_clock::duration slack{0};   // Допустимое опоздание
+};
+
+//------------------------------------------------------------------------------
+
+class Alarm_service {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Time = Clock::time_point;
+    using Duration = Clock::duration;
+    using Handler = std::function<void(std::span<const Alarm>)>;
+    using Id = Timing_wheel<Alarm>::Handle;
+
+    explicit Alarm_service(Handler h, Alarm_options o = {})
+        : opts{o}, handler{std::move(h)}, epoch{Clock::now()},
+          worker{[this] { run(); }} {}
+
+    Alarm_service(const Alarm_service&) = delete;
+    Alarm_service& operator=(const Alarm_service&) = delete;
+
+    ~Alarm_service()
+    {
+        {
+            std::lock_guard<std::mutex> g{m};
+            stop = true;
+        }
+        cv.notify_one();
+        worker.join();
+    }
+
+    // В момент t издать звук s продолжительностью d
+    Id set_alarm(Time t, Sound s, Duration d)
+    { return set_alarm(t, s, d, Volume::Normal); }
+
+    // В момент t издать звук s продолжительностью d и громкостью v
+    Id set_alarm(Time t, Sound s, Duration d, Volume v)
+    {
+        auto tick = tick_of(t);
+        Id id;
+        bool earlier;
+        {
+            std::lock_guard<std::mutex> g{m};
+            id = wheel.schedule(tick, Alarm{t, s, d, v});
+            earlier = tick < sleeping_until;
+        }
+        if (earlier) cv.notify_one();
+        return id;
+    }
+
+    // false, если будильник уже сработал или отменен
+    bool cancel(Id id)
+    {
+        std::lock_guard<std::mutex> g{m};
+        return wheel.cancel(id);
+    }
+
+    std::size_t pending() const
+    {
+        std::lock_guard<std::mutex> g{m};
+        return wheel.size();
+    }
+
+    // Пробуждений потока с непустой пачкой
+    std::uint64_t batches() const
+    {
+        std::lock_guard<std::mutex> g{m};
+        return batch_count;
+    }
+private:
+    using Tick = Timing_wheel<Alarm>::Tick;
+
+    static constexpr Tick never = ~Tick{0};
+
+    // Округление вверх: будильник не срабатывает раньше t
+    Tick tick_of(Time t) const noexcept
+    {
+        if (t <= epoch) return 0;
+        return Tick((t - epoch + opts.tick - Duration{1}) / opts.tick);
+    }
+
+    Time time_of(Tick tick) const noexcept
+    { return epoch + opts.tick * static_cast<Duration::rep>(tick); }
+
+    Tick elapsed_ticks() const noexcept
+    { return Tick((Clock::now() - epoch) / opts.tick); }
+
+    void run()
+    {
+        std::vector<Alarm> batch;
+        std::unique_lock<std::mutex> lock{m};
+        while (!stop) {
+            batch.clear();
+            wheel.advance(elapsed_ticks(), [&batch] (Tick, Alarm&& a)
+            { batch.push_back(std::move(a)); });
+
+            if (!batch.empty()) {
+                ++batch_count;
+                lock.unlock();
+                handler(std::span<const Alarm>{batch});
+                lock.lock();
+                continue;
+            }
+
+            auto bound = wheel.next_bound();
+            sleeping_until = bound ? *bound : never;
+            if (bound) cv.wait_until(lock, time_of(*bound) + opts.slack);
+            else cv.wait(lock);
+            sleeping_until = 0;         // Не спим: уведомлять незачем
+        }
+    }
+
+    Alarm_options opts;
+    Handler handler;
+    Time epoch;
+
+    mutable std::mutex m;
+    std::condition_variable cv;
+    Timing_wheel<Alarm> wheel;
+    Tick sleeping_until{0};
+    std::uint64_t batch_count{0};
+    bool stop{false};
+
+    std::thread worker;                 // Последним: стартует после полей
+};
+
+//------------------------------------------------------------------------------
+
+} // namespace em
+
+//------------------------------------------------------------------------------
+
+#endif // ALARM_SERVICE_HPP
+
+//------------------------------------------------------------------------------
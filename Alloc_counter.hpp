@@ -0,0 +1,294 @@
+//------------------------------------------------------------------------------
+
+// Подсчет динамических аллокаций: проверка утверждений разделов 4.4
+// (make_shared против new) и главы 5 (перемещение против копирования)
+
+// Подключение включено явно: ровно в одной единице трансляции перед
+// #include "Alloc_counter.hpp" нужно определить
+// EM_ALLOC_COUNTER_IMPLEMENTATION, тогда там появятся заменяющие
+// глобальные operator new/delete. Без этого Alloc_scope ничего не считает
+
+//------------------------------------------------------------------------------
+
+#ifndef ALLOC_COUNTER_HPP
+#define ALLOC_COUNTER_HPP
+
+//------------------------------------------------------------------------------
+
+#include <atomic>
+#include <cstddef>
+
+//------------------------------------------------------------------------------
+
+namespace em {
+
+//------------------------------------------------------------------------------
+
+struct Alloc_stats {
+    std::size_t allocations{0};
+    std::size_t deallocations{0};
+    std::size_t bytes_allocated{0};
+    std::size_t bytes_freed{0};
+    std::size_t peak_live_bytes{0};     // Максимум (выделено - освобождено)
+
+    // Может быть отрицательным, если освобождалась память,
+    // выделенная до начала подсчета
+    std::ptrdiff_t live_bytes() const
+    {
+        return static_cast<std::ptrdiff_t>(bytes_allocated)
+             - static_cast<std::ptrdiff_t>(bytes_freed);
+    }
+};
+
+//------------------------------------------------------------------------------
+// Установлены ли заменяющие operator new/delete
+
+inline std::atomic<bool> alloc_counter_installed{false};
+
+//------------------------------------------------------------------------------
+// Счетчики всей программы (все потоки)
+
+class Alloc_totals {
+public:
+    static Alloc_stats snapshot() noexcept
+    {
+        Alloc_stats st;
+        st.allocations     = allocs.load(std::memory_order_relaxed);
+        st.deallocations   = deallocs.load(std::memory_order_relaxed);
+        st.bytes_allocated = bytes_in.load(std::memory_order_relaxed);
+        st.bytes_freed     = bytes_out.load(std::memory_order_relaxed);
+        st.peak_live_bytes = peak.load(std::memory_order_relaxed);
+        return st;
+    }
+
+    static void on_alloc(std::size_t n) noexcept
+    {
+        allocs.fetch_add(1, std::memory_order_relaxed);
+        bytes_in.fetch_add(n, std::memory_order_relaxed);
+        auto now = live.fetch_add(n, std::memory_order_relaxed) + n;
+        auto old = peak.load(std::memory_order_relaxed);
+        while (old < now
+               && !peak.compare_exchange_weak(old, now,
+                                              std::memory_order_relaxed))
+            ;
+    }
+
+    static void on_free(std::size_t n) noexcept
+    {
+        deallocs.fetch_add(1, std::memory_order_relaxed);
+        bytes_out.fetch_add(n, std::memory_order_relaxed);
+        live.fetch_sub(n, std::memory_order_relaxed);
+    }
+private:
+    inline static std::atomic<std::size_t> allocs{0};
+    inline static std::atomic<std::size_t> deallocs{0};
+    inline static std::atomic<std::size_t> bytes_in{0};
+    inline static std::atomic<std::size_t> bytes_out{0};
+    inline static std::atomic<std::size_t> live{0};
+    inline static std::atomic<std::size_t> peak{0};
+};
+
+// Число вызовов operator new с начала работы программы
+inline std::size_t allocation_count() noexcept
+{ return Alloc_totals::snapshot().allocations; }
+
+//------------------------------------------------------------------------------
+// RAII-область подсчета: пока объект жив, учитываются аллокации
+// и освобождения текущего потока. Области вкладываются друг в друга
+// (внешняя видит все, что видит внутренняя) и должны уничтожаться
+// в обратном порядке создания, как обычные локальные переменные
+//
+//     {
+//         em::Alloc_scope scope;
+//         auto spw = std::make_shared<Widget>();
+//         assert(scope.allocations() == 1);
+//     }
+
+class Alloc_scope {
+public:
+    Alloc_scope() noexcept
+        : parent{current} { current = this; }
+    ~Alloc_scope() { current = parent; }
+
+    Alloc_scope(const Alloc_scope&) = delete;
+    Alloc_scope& operator=(const Alloc_scope&) = delete;
+
+    const Alloc_stats& stats() const noexcept { return st; }
+
+    std::size_t allocations() const noexcept { return st.allocations; }
+    std::size_t deallocations() const noexcept { return st.deallocations; }
+    std::size_t bytes() const noexcept { return st.bytes_allocated; }
+    std::size_t peak_bytes() const noexcept { return st.peak_live_bytes; }
+
+    // Обнуление счетчиков, например между прогревом и замером
+    void reset() noexcept { st = {}; live = 0; }
+
+    // Вызываются из заменяющих operator new/delete
+    static void on_alloc(std::size_t n) noexcept
+    {
+        for (auto* s = current; s; s = s->parent) {
+            ++s->st.allocations;
+            s->st.bytes_allocated += n;
+            s->live += static_cast<std::ptrdiff_t>(n);
+            if (s->live > 0
+                && static_cast<std::size_t>(s->live) > s->st.peak_live_bytes)
+                s->st.peak_live_bytes = static_cast<std::size_t>(s->live);
+        }
+    }
+
+    static void on_free(std::size_t n) noexcept
+    {
+        for (auto* s = current; s; s = s->parent) {
+            ++s->st.deallocations;
+            s->st.bytes_freed += n;
+            s->live -= static_cast<std::ptrdiff_t>(n);
+        }
+    }
+private:
+    inline static thread_local Alloc_scope* current{nullptr};
+
+    Alloc_scope* parent;
+    Alloc_stats st;
+    std::ptrdiff_t live{0};
+};
+
+//------------------------------------------------------------------------------
+
+} // namespace em
+
+//------------------------------------------------------------------------------
+
+#endif // ALLOC_COUNTER_HPP
+
+//------------------------------------------------------------------------------
+// Заменяющие operator new/delete. Размер блока хранится в заголовке
+// перед пользовательской памятью, чтобы при освобождении знать,
+// сколько байт вернулось. Формы new[]/delete[] и nothrow заменены тоже:
+// по стандарту они вызывают обычные, но среда выполнения (например,
+// AddressSanitizer) может перехватывать их отдельно, и тогда блок без
+// заголовка попал бы в наш delete
+
+#if defined(EM_ALLOC_COUNTER_IMPLEMENTATION) \
+    && !defined(EM_ALLOC_COUNTER_IMPLEMENTED)
+#define EM_ALLOC_COUNTER_IMPLEMENTED
+
+#include <cstdlib>
+#include <new>
+
+namespace em::alloc_detail {
+
+constexpr std::size_t header_size = alignof(std::max_align_t);
+
+// Смещение пользовательского блока от начала выделенной памяти
+constexpr std::size_t offset_for(std::size_t align) noexcept
+{ return align > header_size ? align : header_size; }
+
+inline void* counted_alloc(std::size_t size, std::size_t align)
+{
+    auto offset = offset_for(align);
+    auto total = (size + offset + align - 1) / align * align;
+    void* base = align > header_size ? std::aligned_alloc(align, total)
+                                     : std::malloc(total);
+    if (!base) throw std::bad_alloc{};
+
+    auto* user = static_cast<char*>(base) + offset;
+    *reinterpret_cast<std::size_t*>(user - sizeof(std::size_t)) = size;
+    Alloc_totals::on_alloc(size);
+    Alloc_scope::on_alloc(size);
+    return user;
+}
+
+inline void counted_free(void* p, std::size_t align) noexcept
+{
+    if (!p) return;
+    auto* user = static_cast<char*>(p);
+    auto size = *reinterpret_cast<std::size_t*>(user - sizeof(std::size_t));
+    Alloc_totals::on_free(size);
+    Alloc_scope::on_free(size);
+    std::free(user - offset_for(align));
+}
+
+struct Installer {
+    Installer() { alloc_counter_installed.store(true); }
+};
+inline Installer installer;
+
+} // namespace em::alloc_detail
+
+void* operator new(std::size_t size)
+{
+    return em::alloc_detail::counted_alloc(size, em::alloc_detail::header_size);
+}
+
+void* operator new(std::size_t size, std::align_val_t align)
+{
+    return em::alloc_detail::counted_alloc(size,
+                                           static_cast<std::size_t>(align));
+}
+
+void operator delete(void* p) noexcept
+{
+    em::alloc_detail::counted_free(p, em::alloc_detail::header_size);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    em::alloc_detail::counted_free(p, em::alloc_detail::header_size);
+}
+
+void operator delete(void* p, std::align_val_t align) noexcept
+{
+    em::alloc_detail::counted_free(p, static_cast<std::size_t>(align));
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t align) noexcept
+{
+    em::alloc_detail::counted_free(p, static_cast<std::size_t>(align));
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return ::operator new(size); }
+    catch (...) { return nullptr; }
+}
+
+void* operator new(std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept
+{
+    try { return ::operator new(size, align); }
+    catch (...) { return nullptr; }
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept { ::operator delete(p); }
+
+void operator delete(void* p, std::align_val_t align, const std::nothrow_t&) noexcept
+{ ::operator delete(p, align); }
+
+void* operator new[](std::size_t size) { return ::operator new(size); }
+
+void* operator new[](std::size_t size, std::align_val_t align)
+{ return ::operator new(size, align); }
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept
+{ return ::operator new(size, tag); }
+
+void* operator new[](std::size_t size, std::align_val_t align, const std::nothrow_t& tag) noexcept
+{ return ::operator new(size, align, tag); }
+
+void operator delete[](void* p) noexcept { ::operator delete(p); }
+
+void operator delete[](void* p, std::size_t) noexcept { ::operator delete(p); }
+
+void operator delete[](void* p, std::align_val_t align) noexcept
+{ ::operator delete(p, align); }
+
+void operator delete[](void* p, std::size_t, std::align_val_t align) noexcept
+{ ::operator delete(p, align); }
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept { ::operator delete(p); }
+
+void operator delete[](void* p, std::align_val_t align, const std::nothrow_t&) noexcept
+{ ::operator delete(p, align); }
+
+#endif // EM_ALLOC_COUNTER_IMPLEMENTATION
+
+//------------------------------------------------------------------------------
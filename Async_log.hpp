@@ -0,0 +1,477 @@
+//------------------------------------------------------------------------------
+
+// Асинхронный журнал для make_log_entry (Facilities.hpp)
+
+// Каждый поток-производитель пишет компактные двоичные записи в свой
+// кольцевой буфер (один писатель, один читатель, без блокировок).
+// Фоновый поток забирает записи пачками, форматирует и сбрасывает их
+// одним вызовом fwrite. Производитель никогда не ждет ввода-вывода и
+// не захватывает общий мьютекс; единственное исключение - первая
+// запись потока, которая регистрирует его буфер. При переполнении
+// буфера запись отбрасывается и учитывается в dropped()
+
+//------------------------------------------------------------------------------
+
+#ifndef ASYNC_LOG_HPP
+#define ASYNC_LOG_HPP
+
+//------------------------------------------------------------------------------
+
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+namespace em {
+
+//------------------------------------------------------------------------------
+// Одно поле записи; 16 байт
+
+struct Log_arg {
+    enum class Kind : std::uint8_t {
+        none, i64, u64, f64, ptr, static_text, inline_text, time, duration
+    };
+
+    Kind kind{Kind::none};
+    std::uint32_t len{0};           // Длина текста (static_text, inline_text)
+    union {
+        std::int64_t i;
+        std::uint64_t u;
+        double d;
+        const void* p;
+        const char* s;
+    };
+
+    Log_arg() : i{0} {}
+};
+
+// Запись журнала; ровно две кэш-линии
+struct alignas(64) Log_record {
+    static constexpr std::size_t max_args = 4;
+    static constexpr std::size_t text_capacity = 40;
+
+    std::int64_t timestamp{0};      // Наносекунды system_clock
+    std::uint32_t thread{0};        // Порядковый номер потока
+    std::uint8_t nargs{0};
+    Log_arg args[max_args];
+    char text[text_capacity];       // Копия одной нестатической строки
+    std::uint8_t text_used{0};
+};
+
+static_assert(sizeof(Log_record) == 128);
+
+//------------------------------------------------------------------------------
+// Текст со статическим временем жизни (строковый литерал, static-массив):
+// в запись попадает только указатель, форматирует его фоновый поток.
+// Конструктор consteval, поэтому локальный массив не скомпилируется:
+//     static constexpr auto call = em::static_text("Вызов");
+//     make_log_entry(call, now);
+
+class Static_text {
+public:
+    template<std::size_t N>
+    consteval Static_text(const char (&text)[N]) noexcept
+        : s{text}, n{static_cast<std::uint32_t>(std::char_traits<char>::length(text))} {}
+
+    const char* data() const noexcept { return s; }
+    std::uint32_t size() const noexcept { return n; }
+private:
+    const char* s;
+    std::uint32_t n;
+};
+
+template<std::size_t N>
+consteval Static_text static_text(const char (&text)[N]) noexcept { return Static_text{text}; }
+
+//------------------------------------------------------------------------------
+// Преобразование аргументов make_log_entry в поля записи.
+// Только Static_text хранится указателем; все строки, в том числе
+// массивы const char, копируются в запись (с усечением)
+
+namespace log_detail {
+
+template<class T> struct Is_time_point : std::false_type {};
+template<class C, class D>
+struct Is_time_point<std::chrono::time_point<C, D>> : std::true_type {};
+
+template<class T> struct Is_duration : std::false_type {};
+template<class R, class P>
+struct Is_duration<std::chrono::duration<R, P>> : std::true_type {};
+
+inline void put_text(Log_record& rec, Log_arg& arg, std::string_view sv)
+{
+    auto room = Log_record::text_capacity - rec.text_used;
+    auto n = sv.size() < room ? sv.size() : room;
+    std::memcpy(rec.text + rec.text_used, sv.data(), n);
+    arg.kind = Log_arg::Kind::inline_text;
+    arg.u = rec.text_used;          // Смещение в rec.text
+    arg.len = static_cast<std::uint32_t>(n);
+    rec.text_used += static_cast<std::uint8_t>(n);
+}
+
+template<class T>
+void put(Log_record& rec, const T& value)
+{
+    if (rec.nargs == Log_record::max_args) return;
+    auto& arg = rec.args[rec.nargs++];
+
+    using U = std::remove_cv_t<T>;
+    if constexpr (std::is_same_v<U, Static_text>) {
+        arg.kind = Log_arg::Kind::static_text;
+        arg.s = value.data();
+        arg.len = value.size();
+    }
+    else if constexpr (std::is_array_v<T>
+                       && std::is_same_v<std::remove_cv_t<std::remove_extent_t<T>>, char>) {
+        std::string_view sv{value, std::extent_v<T>};
+        put_text(rec, arg, sv.substr(0, sv.find('\0')));
+    }
+    else if constexpr (std::is_same_v<U, const char*>
+                       || std::is_same_v<U, char*>)
+        put_text(rec, arg, value ? std::string_view{value} : "(null)");
+    else if constexpr (std::is_convertible_v<const U&, std::string_view>)
+        put_text(rec, arg, std::string_view{value});
+    else if constexpr (std::is_enum_v<U>) {
+        arg.kind = Log_arg::Kind::i64;
+        arg.i = static_cast<std::int64_t>(value);
+    }
+    else if constexpr (std::is_floating_point_v<U>) {
+        arg.kind = Log_arg::Kind::f64;
+        arg.d = value;
+    }
+    else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) {
+        arg.kind = Log_arg::Kind::i64;
+        arg.i = value;
+    }
+    else if constexpr (std::is_integral_v<U>) {
+        arg.kind = Log_arg::Kind::u64;
+        arg.u = value;
+    }
+    else if constexpr (std::is_pointer_v<U>) {
+        arg.kind = Log_arg::Kind::ptr;
+        arg.p = const_cast<const void*>(
+                    static_cast<const volatile void*>(value));
+    }
+    else if constexpr (Is_time_point<U>::value) {
+        arg.kind = Log_arg::Kind::time;
+        arg.i = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    value.time_since_epoch()).count();
+    }
+    else if constexpr (Is_duration<U>::value) {
+        arg.kind = Log_arg::Kind::duration;
+        arg.i = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    value).count();
+    }
+    else
+        static_assert(!sizeof(T), "make_log_entry: неподдерживаемый тип");
+}
+
+} // namespace log_detail
+
+//------------------------------------------------------------------------------
+// Кольцевой буфер: пишет только поток-владелец, читает только фоновый
+// поток. Индексы растут монотонно, позиция - индекс & mask
+
+class Log_ring {
+public:
+    explicit Log_ring(std::size_t capacity, std::uint32_t thread_no)
+        : slots(capacity), mask{capacity - 1}, thread{thread_no} {}
+
+    bool push(const Log_record& rec) noexcept
+    {
+        auto t = tail.load(std::memory_order_relaxed);
+        if (t - cached_head == slots.size()) {
+            cached_head = head.load(std::memory_order_acquire);
+            if (t - cached_head == slots.size()) {
+                dropped_count.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+        slots[t & mask] = rec;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Вызывается только фоновым потоком; возвращает число записей
+    template<class F>
+    std::size_t drain(F&& consume, std::size_t max_batch)
+    {
+        auto h = head.load(std::memory_order_relaxed);
+        auto t = tail.load(std::memory_order_acquire);
+        std::size_t n = 0;
+        for (; h != t && n < max_batch; ++h, ++n)
+            consume(slots[h & mask]);
+        head.store(h, std::memory_order_release);
+        return n;
+    }
+
+    bool empty() const noexcept
+    {
+        return head.load(std::memory_order_acquire)
+            == tail.load(std::memory_order_acquire);
+    }
+
+    std::uint64_t dropped() const noexcept
+    { return dropped_count.load(std::memory_order_relaxed); }
+
+    std::uint32_t thread_no() const noexcept { return thread; }
+
+    std::atomic<bool> retired{false};   // Поток-владелец завершился
+private:
+    std::vector<Log_record> slots;
+    const std::size_t mask;
+    const std::uint32_t thread;
+
+    alignas(64) std::atomic<std::size_t> head{0};   // Читатель
+    alignas(64) std::atomic<std::size_t> tail{0};   // Писатель
+    std::size_t cached_head{0};                     // Копия head у писателя
+    std::atomic<std::uint64_t> dropped_count{0};
+};
+
+//------------------------------------------------------------------------------
+
+class Async_log {
+public:
+    static constexpr std::size_t ring_capacity = 1024;  // Степень двойки
+    static constexpr std::size_t batch_size = 256;
+
+    static Async_log& instance()
+    {
+        static Async_log log;
+        return log;
+    }
+
+    // Куда выводить журнал; nullptr - только форматировать (для замеров)
+    void set_output(std::FILE* f) { output.store(f); }
+
+    template<class... Ts>
+    void write(const Ts&... values)
+    {
+        Log_record rec;
+        rec.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::system_clock::now().time_since_epoch())
+                .count();
+        auto& ring = local_ring();
+        rec.thread = ring.thread_no();
+        (log_detail::put(rec, values), ...);
+        ring.push(rec);
+    }
+
+    // Суммарно отброшено записей из-за переполнения буферов
+    std::uint64_t dropped() const
+    {
+        std::lock_guard<std::mutex> g{rings_mutex};
+        std::uint64_t n = retired_dropped;
+        for (const auto& r : rings) n += r->dropped();
+        return n;
+    }
+
+    // Ожидание, пока фоновый поток не выведет все уже записанное.
+    // Может блокировать; не предназначено для горячего пути
+    void flush()
+    {
+        for (;;) {
+            bool all_empty = true;
+            {
+                std::lock_guard<std::mutex> g{rings_mutex};
+                for (const auto& r : rings)
+                    all_empty = all_empty && r->empty();
+            }
+            if (all_empty && !busy.load(std::memory_order_acquire)) return;
+            std::this_thread::sleep_for(poll_interval);
+        }
+    }
+
+    ~Async_log()
+    {
+        stopping.store(true, std::memory_order_release);
+        if (worker.joinable()) worker.join();
+    }
+private:
+    static constexpr std::chrono::microseconds poll_interval{500};
+
+    Async_log()
+        : worker{[this] { run(); }} {}
+
+    Async_log(const Async_log&) = delete;
+    Async_log& operator=(const Async_log&) = delete;
+
+    // Буфер текущего потока; регистрируется при первой записи
+    struct Ring_holder {
+        std::shared_ptr<Log_ring> ring;
+        ~Ring_holder() { if (ring) ring->retired.store(true); }
+    };
+
+    Log_ring& local_ring()
+    {
+        thread_local Ring_holder holder;
+        if (!holder.ring) {
+            std::lock_guard<std::mutex> g{rings_mutex};
+            holder.ring = std::make_shared<Log_ring>(ring_capacity,
+                                                     next_thread_no++);
+            rings.push_back(holder.ring);
+        }
+        return *holder.ring;
+    }
+
+    void run()
+    {
+        std::string buf;
+        std::vector<std::shared_ptr<Log_ring>> snapshot;
+        std::uint64_t reported_dropped = 0;
+
+        for (;;) {
+            bool stop = stopping.load(std::memory_order_acquire);
+            busy.store(true, std::memory_order_release);
+            {
+                std::lock_guard<std::mutex> g{rings_mutex};
+                snapshot = rings;
+            }
+
+            std::size_t drained = 0;
+            for (const auto& r : snapshot)
+                while (auto n = r->drain([&] (const Log_record& rec)
+                                         { format(buf, rec); }, batch_size)) {
+                    drained += n;
+                    write_out(buf);
+                }
+
+            auto now_dropped = dropped();
+            if (now_dropped != reported_dropped) {
+                buf += "[log] dropped "
+                     + std::to_string(now_dropped - reported_dropped)
+                     + " records\n";
+                reported_dropped = now_dropped;
+                write_out(buf);
+            }
+
+            remove_retired();
+            busy.store(false, std::memory_order_release);
+
+            if (stop) break;
+            if (!drained) std::this_thread::sleep_for(poll_interval);
+        }
+        if (auto* f = output.load()) std::fflush(f);
+    }
+
+    void write_out(std::string& buf)
+    {
+        if (auto* f = output.load(); f && !buf.empty()) {
+            std::fwrite(buf.data(), 1, buf.size(), f);
+            std::fflush(f);
+        }
+        buf.clear();
+    }
+
+    // Буферы завершившихся потоков удаляются после опустошения
+    void remove_retired()
+    {
+        std::lock_guard<std::mutex> g{rings_mutex};
+        for (auto it = rings.begin(); it != rings.end();) {
+            if ((*it)->retired.load() && (*it)->empty()) {
+                retired_dropped += (*it)->dropped();
+                it = rings.erase(it);
+            }
+            else
+                ++it;
+        }
+    }
+
+    static void format(std::string& out, const Log_record& rec)
+    {
+        char tmp[64];
+        std::snprintf(tmp, sizeof tmp, "%" PRId64 ".%09" PRId64 " [%u]",
+                      rec.timestamp / 1000000000, rec.timestamp % 1000000000,
+                      static_cast<unsigned>(rec.thread));
+        out += tmp;
+
+        for (std::uint8_t i = 0; i < rec.nargs; ++i) {
+            const auto& a = rec.args[i];
+            out += ' ';
+            switch (a.kind) {
+            case Log_arg::Kind::i64:
+                std::snprintf(tmp, sizeof tmp, "%" PRId64, a.i);
+                out += tmp;
+                break;
+            case Log_arg::Kind::u64:
+                std::snprintf(tmp, sizeof tmp, "%" PRIu64, a.u);
+                out += tmp;
+                break;
+            case Log_arg::Kind::f64:
+                std::snprintf(tmp, sizeof tmp, "%g", a.d);
+                out += tmp;
+                break;
+            case Log_arg::Kind::ptr:
+                std::snprintf(tmp, sizeof tmp, "%p", a.p);
+                out += tmp;
+                break;
+            case Log_arg::Kind::static_text:
+                out.append(a.s, a.len);
+                break;
+            case Log_arg::Kind::inline_text:
+                out.append(rec.text + a.u, a.len);
+                break;
+            case Log_arg::Kind::time:
+                std::snprintf(tmp, sizeof tmp, "%" PRId64 ".%09" PRId64,
+                              a.i / 1000000000, a.i % 1000000000);
+                out += tmp;
+                break;
+            case Log_arg::Kind::duration:
+                std::snprintf(tmp, sizeof tmp, "%" PRId64 "ns", a.i);
+                out += tmp;
+                break;
+            case Log_arg::Kind::none:
+                break;
+            }
+        }
+        out += '\n';
+    }
+
+    mutable std::mutex rings_mutex;     // Только регистрация и обход
+    std::vector<std::shared_ptr<Log_ring>> rings;
+    std::uint32_t next_thread_no{0};
+    std::uint64_t retired_dropped{0};
+
+    std::atomic<std::FILE*> output{stderr};
+    std::atomic<bool> stopping{false};
+    std::atomic<bool> busy{false};
+    std::thread worker;                 // Последним: стартует в конструкторе
+};
+
+//------------------------------------------------------------------------------
+
+} // namespace em
+
+//------------------------------------------------------------------------------
+// Реализация make_log_entry, объявленной в Facilities.hpp
+
+template<class T>
+void make_log_entry(T& entry)
+{
+    em::Async_log::instance().write(entry);
+}
+
+// Запись из нескольких полей, например make_log_entry("Вызов", now)
+template<class T, class U, class... Ts>
+void make_log_entry(T& first, U& second, Ts&... rest)
+{
+    em::Async_log::instance().write(first, second, rest...);
+}
+
+//------------------------------------------------------------------------------
+
+#endif // ASYNC_LOG_HPP
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,451 @@
+//------------------------------------------------------------------------------
+
+// Микробенчмарки: рабочая версия time_func_invocation из раздела 5.2
+
+//------------------------------------------------------------------------------
+
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+//------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+namespace em {
+
+//------------------------------------------------------------------------------
+
+using Bench_clock = std::chrono::steady_clock;
+using Nanoseconds = std::chrono::duration<double, std::nano>;
+
+//------------------------------------------------------------------------------
+// Барьер для оптимизатора: компилятор обязан считать, что value
+// прочитано (и, возможно, изменено), поэтому не может выбросить
+// вычисление, результат которого никому не нужен
+
+template<class T>
+inline void do_not_optimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+template<class T>
+inline void do_not_optimize(T& value)
+{
+#if defined(__clang__)
+    asm volatile("" : "+r,m"(value) : : "memory");
+#elif defined(__GNUC__)                 // GCC ошибается с альтернативами
+    asm volatile("" : "+m"(value) : : "memory");
+#else
+    static volatile void* sink;
+    sink = &value;
+#endif
+}
+
+// Все записи в память должны быть выполнены к этой точке
+inline void clobber_memory()
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : : "memory");
+#endif
+}
+
+//------------------------------------------------------------------------------
+// Однократный замер вызова func с params (раздел 5.2);
+// возвращаемое значение func не может быть выброшено оптимизатором
+
+template<class F, class... Ts>
+Nanoseconds time_func_invocation(F&& func, Ts&&... params)
+{
+    auto start = Bench_clock::now();                // Запуск таймера
+    if constexpr (std::is_void_v<std::invoke_result_t<F, Ts...>>)
+        std::invoke(std::forward<F>(func),
+                    std::forward<Ts>(params)...);
+    else {
+        auto&& res = std::invoke(std::forward<F>(func),
+                                 std::forward<Ts>(params)...);
+        do_not_optimize(res);
+    }
+    return Bench_clock::now() - start;              // Остановка таймера
+}
+
+//------------------------------------------------------------------------------
+
+struct Bench_options {
+    int warmup_runs{2};             // Отбрасываемые замеры после калибровки
+    int samples{30};                // Число замеров, идущих в статистику
+    Nanoseconds min_sample_time{std::chrono::milliseconds(2)};
+    std::size_t max_iterations{std::size_t{1} << 30};
+};
+
+// Результат одного бенчмарка; времена указаны на одну операцию
+struct Bench_result {
+    std::string name;
+    std::size_t iterations{0};      // Итераций в одном замере
+    int samples{0};
+    Nanoseconds min{};
+    Nanoseconds median{};
+    Nanoseconds p99{};
+    Nanoseconds mean{};
+    Nanoseconds max{};
+    // Дополнительные метрики (число аллокаций, байты и т.п.)
+    std::vector<std::pair<std::string, double>> counters;
+
+    Bench_result& counter(std::string key, double value)
+    {
+        counters.emplace_back(std::move(key), value);
+        return *this;
+    }
+};
+
+//------------------------------------------------------------------------------
+// Статистика по замерам, каждый из которых уже приведен к одной операции
+
+inline void fill_stats(Bench_result& res, std::vector<Nanoseconds> per_op)
+{
+    if (per_op.empty()) return;
+    std::sort(per_op.begin(), per_op.end());
+
+    auto n = per_op.size();
+    auto rank = [n] (double q)
+    {
+        auto r = static_cast<std::size_t>(std::ceil(q * n));
+        return std::min(n - 1, r ? r - 1 : 0);
+    };
+
+    Nanoseconds sum{};
+    for (auto t : per_op) sum += t;
+
+    res.samples = static_cast<int>(n);
+    res.min     = per_op.front();
+    res.median  = per_op[rank(0.5)];
+    res.p99     = per_op[rank(0.99)];
+    res.mean    = sum / static_cast<double>(n);
+    res.max     = per_op.back();
+}
+
+//------------------------------------------------------------------------------
+// Вызов op, результат которого (если есть) не может быть выброшен
+
+template<class Op, class... Ts>
+inline void invoke_kept(Op& op, Ts&&... params)
+{
+    if constexpr (std::is_void_v<std::invoke_result_t<Op&, Ts...>>)
+        op(std::forward<Ts>(params)...);
+    else {
+        auto&& res = op(std::forward<Ts>(params)...);
+        do_not_optimize(res);
+    }
+}
+
+//------------------------------------------------------------------------------
+// Замер iters последовательных вызовов op
+
+template<class Op>
+Nanoseconds time_iterations(Op& op, std::size_t iters)
+{
+    auto start = Bench_clock::now();
+    for (std::size_t i = 0; i < iters; ++i) invoke_kept(op);
+    clobber_memory();
+    return Bench_clock::now() - start;
+}
+
+// Подбор числа итераций, при котором один замер длится
+// не меньше opts.min_sample_time (заодно прогревает кэши)
+
+template<class Op>
+std::size_t calibrate_iterations(Op& op, const Bench_options& opts)
+{
+    std::size_t iters = 1;
+    for (;;) {
+        auto t = time_iterations(op, iters);
+        if (t >= opts.min_sample_time || iters >= opts.max_iterations)
+            return iters;
+
+        double factor = t.count() > 0
+                ? opts.min_sample_time / t * 1.4
+                : 10.0;
+        factor = std::clamp(factor, 2.0, 10.0);
+        iters = std::min(opts.max_iterations,
+                         static_cast<std::size_t>(iters * factor));
+    }
+}
+
+//------------------------------------------------------------------------------
+// Полный прогон: калибровка, прогрев, замеры, статистика
+
+template<class Op>
+Bench_result run_benchmark(std::string name, Op&& op,
+                           const Bench_options& opts = {})
+{
+    Bench_result res;
+    res.name = std::move(name);
+    res.iterations = calibrate_iterations(op, opts);
+
+    for (int i = 0; i < opts.warmup_runs; ++i)
+        time_iterations(op, res.iterations);
+
+    std::vector<Nanoseconds> per_op;
+    per_op.reserve(opts.samples);
+    for (int i = 0; i < opts.samples; ++i)
+        per_op.push_back(time_iterations(op, res.iterations)
+                         / static_cast<double>(res.iterations));
+
+    fill_stats(res, std::move(per_op));
+    return res;
+}
+
+//------------------------------------------------------------------------------
+// Прогон op(thread_index) одновременно в threads потоках. Потоки создаются
+// один раз на бенчмарк; каждый замер стартует их общим сигналом.
+// Время в результате - на одну операцию одного потока, счетчик
+// "Mops/s" - суммарная пропускная способность
+
+template<class Op>
+Bench_result run_threaded_benchmark(std::string name, int threads, Op&& op,
+                                    const Bench_options& opts = {})
+{
+    Bench_result res;
+    res.name = std::move(name);
+    auto single = [&op] { invoke_kept(op, std::size_t{0}); };
+    res.iterations = calibrate_iterations(single, opts);
+
+    std::atomic<int> generation{0};
+    std::atomic<int> done{0};
+    std::atomic<bool> quit{false};
+
+    auto work = [&] (std::size_t index)
+    {
+        for (std::size_t i = 0; i < res.iterations; ++i)
+            invoke_kept(op, index);
+        clobber_memory();
+        done.fetch_add(1, std::memory_order_acq_rel);
+    };
+
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threads; ++t)
+        workers.emplace_back([&, t]
+        {
+            int seen = 0;
+            for (;;) {
+                int g;
+                while ((g = generation.load(std::memory_order_acquire)) == seen
+                       && !quit.load(std::memory_order_acquire))
+                    std::this_thread::yield();
+                if (quit.load(std::memory_order_acquire)) return;
+                seen = g;
+                work(static_cast<std::size_t>(t));
+            }
+        });
+
+    auto sample = [&]
+    {
+        done.store(0, std::memory_order_release);
+        auto start = Bench_clock::now();
+        generation.fetch_add(1, std::memory_order_acq_rel);
+        work(0);                                // Главный поток - нулевой
+        while (done.load(std::memory_order_acquire) != threads)
+            std::this_thread::yield();
+        return Nanoseconds{Bench_clock::now() - start};
+    };
+
+    for (int i = 0; i < opts.warmup_runs; ++i) sample();
+
+    std::vector<Nanoseconds> per_op;
+    per_op.reserve(opts.samples);
+    for (int i = 0; i < opts.samples; ++i)
+        per_op.push_back(sample() / static_cast<double>(res.iterations));
+
+    quit.store(true, std::memory_order_release);
+    for (auto& w : workers) w.join();
+
+    fill_stats(res, std::move(per_op));
+    res.counter("threads", threads);
+    res.counter("Mops/s", threads * 1e3 / res.median.count());
+    return res;
+}
+
+//------------------------------------------------------------------------------
+// Вывод результатов
+
+enum class Report_format { text, csv, json };
+
+// Результаты сессии; deque, чтобы добавление нового результата не делало
+// недействительными указатели на прежние
+using Bench_results = std::deque<Bench_result>;
+
+inline std::string json_escape(const std::string& s)
+{
+    std::string out;
+    out.reserve(s.size());
+    for (char c : s) {
+        switch (c) {
+        case '"':  out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n";  break;
+        case '\t': out += "\\t";  break;
+        default:   out += c;
+        }
+    }
+    return out;
+}
+
+// Поле CSV в кавычках; кавычки внутри удваиваются
+inline std::string csv_quote(const std::string& s)
+{
+    std::string out{'"'};
+    for (char c : s) {
+        if (c == '"') out += '"';
+        out += c;
+    }
+    out += '"';
+    return out;
+}
+
+inline void report_text(std::ostream& os, const Bench_results& rs)
+{
+    for (const auto& r : rs) {
+        os << r.name
+           << "  min " << r.min.count() << " ns"
+           << "  median " << r.median.count() << " ns"
+           << "  p99 " << r.p99.count() << " ns"
+           << "  (" << r.samples << " x " << r.iterations << " iters)";
+        for (const auto& [key, value] : r.counters)
+            os << "  " << key << '=' << value;
+        os << '\n';
+    }
+}
+
+inline void report_csv(std::ostream& os, const Bench_results& rs)
+{
+    os << "name,iterations,samples,min_ns,median_ns,p99_ns,mean_ns,max_ns,"
+          "counters\n";
+    for (const auto& r : rs) {
+        std::ostringstream counters;
+        for (std::size_t i = 0; i < r.counters.size(); ++i)
+            counters << (i ? ";" : "")
+                     << r.counters[i].first << '=' << r.counters[i].second;
+        os << csv_quote(r.name) << ','
+           << r.iterations << ',' << r.samples << ','
+           << r.min.count() << ',' << r.median.count() << ','
+           << r.p99.count() << ',' << r.mean.count() << ','
+           << r.max.count() << ',' << csv_quote(counters.str()) << '\n';
+    }
+}
+
+inline void report_json(std::ostream& os, const Bench_results& rs)
+{
+    os << "[\n";
+    for (std::size_t i = 0; i < rs.size(); ++i) {
+        const auto& r = rs[i];
+        os << "  {\"name\": \"" << json_escape(r.name) << "\""
+           << ", \"iterations\": " << r.iterations
+           << ", \"samples\": " << r.samples
+           << ", \"min_ns\": " << r.min.count()
+           << ", \"median_ns\": " << r.median.count()
+           << ", \"p99_ns\": " << r.p99.count()
+           << ", \"mean_ns\": " << r.mean.count()
+           << ", \"max_ns\": " << r.max.count()
+           << ", \"counters\": {";
+        for (std::size_t j = 0; j < r.counters.size(); ++j)
+            os << (j ? ", " : "") << '"' << json_escape(r.counters[j].first)
+               << "\": " << r.counters[j].second;
+        os << "}}" << (i + 1 < rs.size() ? "," : "") << '\n';
+    }
+    os << "]\n";
+}
+
+inline void report(std::ostream& os, const Bench_results& rs,
+                   Report_format fmt)
+{
+    switch (fmt) {
+    case Report_format::text: report_text(os, rs); break;
+    case Report_format::csv:  report_csv(os, rs);  break;
+    case Report_format::json: report_json(os, rs); break;
+    }
+}
+
+//------------------------------------------------------------------------------
+// Сессия: общий набор опций и накопленные результаты.
+// Наборы бенчмарков (bench_*.cpp) регистрируются статически
+// и получают сессию из bench.cpp
+
+class Bench_session {
+public:
+    explicit Bench_session(Bench_options o = {}, std::string f = {})
+        : opts{o}, filter{std::move(f)} {}
+
+    bool enabled(const std::string& name) const
+    { return filter.empty() || name.find(filter) != std::string::npos; }
+
+    // Возвращает добавленный результат, чтобы к нему можно было
+    // дописать счетчики; nullptr, если бенчмарк отфильтрован. Указатель
+    // действителен до уничтожения сессии
+    template<class Op>
+    Bench_result* run(std::string name, Op&& op)
+    {
+        if (!enabled(name)) return nullptr;
+        results.push_back(run_benchmark(std::move(name),
+                                        std::forward<Op>(op), opts));
+        return &results.back();
+    }
+
+    template<class Op>
+    Bench_result* run_threaded(std::string name, int threads, Op&& op)
+    {
+        if (!enabled(name)) return nullptr;
+        results.push_back(run_threaded_benchmark(std::move(name), threads,
+                                                 std::forward<Op>(op), opts));
+        return &results.back();
+    }
+
+    const Bench_options& options() const { return opts; }
+    const Bench_results& all() const { return results; }
+private:
+    Bench_options opts;
+    std::string filter;
+    Bench_results results;
+};
+
+using Bench_suite = std::function<void(Bench_session&)>;
+
+inline std::vector<std::pair<std::string, Bench_suite>>& bench_suites()
+{
+    static std::vector<std::pair<std::string, Bench_suite>> suites;
+    return suites;
+}
+
+struct Bench_registrar {
+    Bench_registrar(std::string name, Bench_suite suite)
+    { bench_suites().emplace_back(std::move(name), std::move(suite)); }
+};
+
+//------------------------------------------------------------------------------
+
+} // namespace em
+
+//------------------------------------------------------------------------------
+
+#endif // BENCHMARK_HPP
+
+//------------------------------------------------------------------------------
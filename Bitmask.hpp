@@ -0,0 +1,153 @@
+//------------------------------------------------------------------------------
+
+// Битовая маска отбора: бит i установлен, если элемент i прошел фильтры
+
+// Хранится словами по 64 бита; биты за пределами size() всегда нулевые,
+// поэтому count() и логические операции работают целыми словами
+
+//------------------------------------------------------------------------------
+
+#ifndef BITMASK_HPP
+#define BITMASK_HPP
+
+//------------------------------------------------------------------------------
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+namespace em {
+
+//------------------------------------------------------------------------------
+
+class Bitmask {
+public:
+    static constexpr std::size_t word_bits = 64;
+
+    explicit Bitmask(std::size_t n = 0, bool value = false)
+        : words((n + word_bits - 1) / word_bits, value ? ~std::uint64_t{0} : 0),
+          n_bits{n}
+    { clear_tail(); }
+
+    std::size_t size() const noexcept { return n_bits; }
+    std::size_t word_count() const noexcept { return words.size(); }
+
+    std::uint64_t* data() noexcept { return words.data(); }
+    const std::uint64_t* data() const noexcept { return words.data(); }
+
+    // Маска допустимых битов слова w (неполное последнее слово)
+    std::uint64_t valid_bits(std::size_t w) const noexcept
+    {
+        auto rest = n_bits - w * word_bits;
+        return rest >= word_bits ? ~std::uint64_t{0}
+                                 : (std::uint64_t{1} << rest) - 1;
+    }
+
+    bool test(std::size_t i) const noexcept
+    { return words[i / word_bits] >> (i % word_bits) & 1; }
+
+    void set(std::size_t i, bool value = true) noexcept
+    {
+        auto bit = std::uint64_t{1} << (i % word_bits);
+        if (value) words[i / word_bits] |= bit;
+        else words[i / word_bits] &= ~bit;
+    }
+
+    void resize(std::size_t n, bool value = false)
+    {
+        auto old = n_bits;
+        words.resize((n + word_bits - 1) / word_bits, value ? ~std::uint64_t{0} : 0);
+        n_bits = n;
+        if (value && old < n && old % word_bits)
+            words[old / word_bits] |= ~std::uint64_t{0} << (old % word_bits);
+        clear_tail();
+    }
+
+    std::size_t count() const noexcept
+    {
+        std::size_t c = 0;
+        for (auto w : words) c += std::popcount(w);
+        return c;
+    }
+
+    bool any() const noexcept
+    {
+        for (auto w : words) if (w) return true;
+        return false;
+    }
+    bool none() const noexcept { return !any(); }
+
+    // Операции над масками одного размера
+    Bitmask& operator&=(const Bitmask& rhs) noexcept
+    {
+        for (std::size_t i = 0; i < words.size(); ++i) words[i] &= rhs.words[i];
+        return *this;
+    }
+    Bitmask& operator|=(const Bitmask& rhs) noexcept
+    {
+        for (std::size_t i = 0; i < words.size(); ++i) words[i] |= rhs.words[i];
+        return *this;
+    }
+    Bitmask& operator^=(const Bitmask& rhs) noexcept
+    {
+        for (std::size_t i = 0; i < words.size(); ++i) words[i] ^= rhs.words[i];
+        return *this;
+    }
+    Bitmask& and_not(const Bitmask& rhs) noexcept       // *this & ~rhs
+    {
+        for (std::size_t i = 0; i < words.size(); ++i) words[i] &= ~rhs.words[i];
+        return *this;
+    }
+    Bitmask& flip() noexcept
+    {
+        for (auto& w : words) w = ~w;
+        clear_tail();
+        return *this;
+    }
+
+    // f(i) для каждого установленного бита по возрастанию i
+    template<class F>
+    void for_each_set(F f) const
+    {
+        for (std::size_t w = 0; w < words.size(); ++w)
+            for (auto bits = words[w]; bits; bits &= bits - 1)
+                f(w * word_bits + std::countr_zero(bits));
+    }
+
+    std::vector<std::uint32_t> indices() const
+    {
+        std::vector<std::uint32_t> out;
+        out.reserve(count());
+        for_each_set([&out] (std::size_t i)
+        { out.push_back(static_cast<std::uint32_t>(i)); });
+        return out;
+    }
+
+    friend bool operator==(const Bitmask& a, const Bitmask& b)
+    { return a.n_bits == b.n_bits && a.words == b.words; }
+    friend bool operator!=(const Bitmask& a, const Bitmask& b)
+    { return !(a == b); }
+private:
+    void clear_tail() noexcept
+    { if (!words.empty()) words.back() &= valid_bits(words.size() - 1); }
+
+    std::vector<std::uint64_t> words;
+    std::size_t n_bits;
+};
+
+inline Bitmask operator&(Bitmask a, const Bitmask& b) { return a &= b; }
+inline Bitmask operator|(Bitmask a, const Bitmask& b) { return a |= b; }
+inline Bitmask operator^(Bitmask a, const Bitmask& b) { return a ^= b; }
+
+//------------------------------------------------------------------------------
+
+} // namespace em
+
+//------------------------------------------------------------------------------
+
+#endif // BITMASK_HPP
+
+//------------------------------------------------------------------------------
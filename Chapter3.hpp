@@ -810,6 +810,8 @@ private:
     mutable bool roots_are_valid{false};
     mutable Root_type root_vals{};
 };
+// Чтение без блокировки и без копирования после публикации корней:
+// em::Polynomial::visit_roots() из Polynomial.hpp
 
 
 class Point {                       // Двумерная точка
@@ -882,6 +884,8 @@ private:
     mutable bool cached_valid{false};   // Не атомарное
     mutable int cached_value;           // Не атомарное
 };
+// Обобщенный кэш для любых типов, без ожиданий после вычисления:
+// em::Lazy<T> из Lazy.hpp
 
 }
 
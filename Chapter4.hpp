@@ -100,6 +100,8 @@ template<class... Ts>               // Возвращаемый тип имее
 std::unique_ptr<Investment,         // Investment* плюс как минимум
     decltype(void(*)(Investment*))> // размер указателя на функцию
 make_investment(Ts&&... params);
+// Размещение Stock/Bond/Real_estate в пуле с тем же удалителем
+// без состояния: em::make_investment из Investment.hpp
 
 }
 
@@ -200,6 +202,8 @@ public:
 private:
     // ...          // Конструкторы
 };
+// Один блок без слабого указателя на себя и указатель в одно слово:
+// em::Ref_counted и em::make_intrusive из Intrusive_ptr.hpp
 
 
 }
@@ -250,6 +254,8 @@ std::shared_ptr<const Widget> fast_load_widget(Widget_id id)
     }
     return obj_ptr;
 }
+// Потокобезопасный вариант с чисткой просроченных записей
+// и горячим LRU-уровнем: em::Weak_cache из Weak_cache.hpp
 
 
 struct B;
@@ -186,6 +186,8 @@ auto time_func_invocation =
     );
     // Остановка таймера и запись времени;
 }
+// Рабочая версия с прогревом и статистикой по замерам:
+// em::time_func_invocation и em::run_benchmark из Benchmark.hpp
 
 
 }
@@ -335,6 +337,8 @@ void log_and_add(T&& name)
     log(now, "log_and_add");
     names.emplace(std::forward<T>(name));
 }
+// Вставка из многих потоков с журнальной записью раз на пачку:
+// em::Concurrent_multiset из Concurrent_multiset.hpp
 std::string pet_name("Darla");          // Как и ранее
 log_and_add(pet_name);                  // Как и ранее, копирование
                                         // lvalue в multiset
@@ -354,6 +358,8 @@ void log_and_add(int idx)               // Новая перегрузка
     log(now, "log_and_add");
     names.emplace(name_from_idx(idx));
 }
+// Имя по индексу без выделения памяти, словарь отображается в память:
+// em::Name_dictionary из Name_dictionary.hpp
 // Разрешение перегрузки работает, как и следовало ожидать
 std::string pet_name("Darla");          // Как и ранее
 log_and_add(pet_name);                  // Как и ранее, эти вызовы
@@ -108,12 +108,16 @@ void work_with_container(const C& container)
         // ...                          // Как минимум одно - нет
     }
 }
+// Та же проверка без деления, SIMD и в нескольких потоках:
+// em::all_divisible(container, divisor) из Divisibility.hpp
 
 
 filters.emplace_back(                   // Теперь
     [=] (int value)                     // divisor
     { return value % divisor == 0; }    // не может
 );                                      // зависнуть
+// Фильтр em::Divisible_by{divisor} вместо лямбда-выражения
+// em::Filter_engine из Filter_engine.hpp проверяет SIMD-ядром
 
 
 class Widget {
@@ -223,12 +227,16 @@ public:
 private:
     // ...
 };
+// Те же флаги для миллионов виджетов столбцами битов:
+// em::Widget_flags из Flag_store.hpp
 auto pw =
     std::make_unique<Widget>();     // Создание Widget
 // ...                              // Настройка *pw
 auto func = [pw = std::move(pw)]    // Инициализация члена
     { return pw->is_validated()     // в замыкании с помощью
           && pw->is_archived(); };  // std::move(pw)
+// Хранить такое замыкание без кучи и без требования копируемости:
+// em::Unique_function из Unique_function.hpp
 
 
 auto func = [pw = std::make_unique<Widget>()]   // Инициализация
@@ -249,6 +257,8 @@ private:
     Data_type pw;
 };
 auto func = Is_val_and_arch{std::make_unique<Widget>()};
+// Выполнение таких замыканий в пуле с захватом работы:
+// em::Thread_pool::submit из Thread_pool.hpp
 
 
 // C++14
@@ -312,6 +322,8 @@ auto f = [](auto&& x)
 
 auto f = [](auto&& x)
 { return  normalize(std::forward<decltype(x)>(x)); };
+// normalize для float/double, различающий rvalue и lvalue:
+// em::normalize из Normalize.hpp
 
 
 auto f = [](auto&&... xs)
@@ -389,6 +401,8 @@ auto set_sound_b =                      // "b" - означает bind
                         hours(1)),
               _1,
               seconds(30));
+// То же без bind и обратных вызовов - сопрограмма em::Task из Task.hpp:
+// co_await loop.sleep_for(1h) на em::Event_loop из Event_loop.hpp
 
 
 // При перегрузке set_alarm
@@ -396,6 +410,8 @@ auto set_sound_b =                      // "b" - означает bind
 enum class Volume { Normal, Loud, Loud_plus_plus };
 // В момент t издать звук s продолжительностью d и громкостью v
 void set_alarm(Time t, Sound s, Duration d, Volume v);
+// Реализация обеих перегрузок на иерархическом колесе таймеров:
+// em::Alarm_service из Alarm_service.hpp
 
 
 // Версия с лямбда-выражениями
@@ -436,6 +452,8 @@ auto between_l =
         [low_val, high_val]
         (const auto& val)                               // C++14
         { return low_val <= val && val <= high_val; };
+// Та же проверка для столбца значений, с IN-списками и NOT BETWEEN:
+// em::Range_predicate из Range_scan.hpp
 
 
 using namespace std::placeholders;
@@ -461,6 +479,8 @@ enum class Comp_level { low, normal, high}; // Уровень сжатия
 // ...
 Widget compress(const Widget& w,            // Создание сжатой
                 Comp_level lev);            // копии w
+// Сжатие фрагментами на всех ядрах и потоковый Compress_stream:
+// em::compress из Compression.hpp
 // ...
 Widget w;
 auto compress_rate_b = std::bind(compress, w, _1);
@@ -51,6 +51,8 @@ public:
 private:
     std::vector<std::string> names;
 };
+// Имена из общего словаря без блока кучи на каждое имя:
+// em::Name_store и em::Interned_name из Name_store.hpp
 // ...
 Widget w;
 // ...
@@ -205,6 +207,8 @@ ptrs.push_back(std::move(spw));             // Добавление spw
                                             // как rvalue
 // Версия с emplace_back:
 ptrs.emplace_back(std::move(spw));
+// Реестр блоками со стабильными адресами вместо узла на элемент:
+// em::Hive из Hive.hpp
 
 
 std::vector<std::regex> regexes;
@@ -212,6 +216,8 @@ regexes.emplace_back(nullptr);      // Компилируется, "все ок"
 std::regex r = nullptr;             // Ошибка! Не компилируется! Конструктор explicit
 regexes.push_back(nullptr);         // Ошибка! Не компилируется! Конструктор explicit
 std::regex upper_case_word("[A-Z]+");
+// Весь набор шаблонов за один проход по тексту:
+// em::Regex_set из Regex_set.hpp
 std::regex r(nullptr);              // Компилируется
 std::regex r1 = nullptr;            // Ошибка! Не компилируется!
 std::regex r2(nullptr);             // Компилируется
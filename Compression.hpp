@@ -0,0 +1,508 @@
+//------------------------------------------------------------------------------
+
+// Сжатие для compress(const Widget&, Comp_level) из раздела 6.4
+
+// Данные режутся на независимые фрагменты (по умолчанию 256 КиБ), каждый
+// сжимается собственным LZ77-кодеком (формат последовательностей в духе
+// LZ4, окно 64 КиБ) в отдельной задаче std::async, а результаты пишутся
+// в приемник строго по порядку. Compress_stream принимает байты потоком:
+// объект сериализуется функцией serialize(const W&, Compress_stream&),
+// найденной по ADL, и целиком в памяти не собирается - одновременно
+// существуют лишь фрагменты "в работе" (не больше 2 * threads).
+// Уровни: low - одна проба хеш-таблицы и ускоренный пропуск
+// несжимаемых участков, normal - цепочки совпадений глубиной 16,
+// high - глубина 256 и ленивый выбор совпадения
+
+// Формат: "EMZ1", затем фрагменты [raw_size:u32][stored_size:u32]
+// [method:u8][данные], где method 0 - без сжатия, 1 - LZ; фрагмент с
+// raw_size == 0 завершает поток. Числа - little-endian
+
+//------------------------------------------------------------------------------
+
+#ifndef COMPRESSION_HPP
+#define COMPRESSION_HPP
+
+//------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <future>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+namespace em {
+
+//------------------------------------------------------------------------------
+
+enum class Comp_level { low, normal, high };    // Уровень сжатия
+
+//------------------------------------------------------------------------------
+// LZ-кодек одного фрагмента
+
+namespace lz_detail {
+
+constexpr std::size_t min_match = 4;
+constexpr std::size_t max_offset = 65535;
+constexpr std::size_t window = std::size_t{1} << 16;
+constexpr std::uint32_t nil = ~std::uint32_t{0};
+
+struct Level_params {
+    unsigned hash_bits;
+    unsigned chain_depth;               // 1 - без цепочек
+    std::size_t nice_length;            // Достаточно длинное совпадение
+    bool lazy;
+    bool accelerate;                    // Ускоренный пропуск при промахах
+};
+
+inline Level_params params_of(Comp_level level) noexcept
+{
+    switch (level) {
+    case Comp_level::low:  return {12, 1, 64, false, true};
+    case Comp_level::high: return {16, 256, 256, true, false};
+    default:               return {16, 16, 64, false, false};
+    }
+}
+
+inline std::uint32_t load32(const std::byte* p) noexcept
+{
+    std::uint32_t v;
+    std::memcpy(&v, p, sizeof v);
+    return v;
+}
+
+inline std::uint32_t hash4(const std::byte* p, unsigned bits) noexcept
+{ return (load32(p) * 2654435761u) >> (32 - bits); }
+
+// Длина общего префикса a и b, не больше limit
+inline std::size_t common_length(const std::byte* a, const std::byte* b,
+                                 std::size_t limit) noexcept
+{
+    std::size_t n = 0;
+    if constexpr (std::endian::native == std::endian::little) {
+        for (; n + 8 <= limit; n += 8) {
+            std::uint64_t x, y;
+            std::memcpy(&x, a + n, 8);
+            std::memcpy(&y, b + n, 8);
+            if (x != y) return n + std::countr_zero(x ^ y) / 8;
+        }
+    }
+    while (n < limit && a[n] == b[n]) ++n;
+    return n;
+}
+
+inline void put_length(std::vector<std::byte>& out, std::size_t len)
+{
+    for (; len >= 255; len -= 255) out.push_back(std::byte{255});
+    out.push_back(std::byte(len));
+}
+
+// Литералы и (если match_len != 0) совпадение; последняя
+// последовательность фрагмента - только литералы
+inline void put_sequence(std::vector<std::byte>& out, const std::byte* lit,
+                         std::size_t lit_len, std::size_t offset,
+                         std::size_t match_len)
+{
+    auto ml = match_len ? match_len - min_match : 0;
+    out.push_back(std::byte((std::min<std::size_t>(lit_len, 15) << 4)
+                            | std::min<std::size_t>(ml, 15)));
+    if (lit_len >= 15) put_length(out, lit_len - 15);
+    out.insert(out.end(), lit, lit + lit_len);
+    if (!match_len) return;
+    out.push_back(std::byte(offset & 0xFF));
+    out.push_back(std::byte(offset >> 8));
+    if (ml >= 15) put_length(out, ml - 15);
+}
+
+inline void compress_block(const std::byte* src, std::size_t n,
+                           Comp_level level, std::vector<std::byte>& out)
+{
+    const auto prm = params_of(level);
+    std::vector<std::uint32_t> head(std::size_t{1} << prm.hash_bits, nil);
+    std::vector<std::uint32_t> chain;
+    if (prm.chain_depth > 1) chain.assign(std::min(n, window), nil);
+
+    auto insert = [&] (std::size_t p)
+    {
+        auto h = hash4(src + p, prm.hash_bits);
+        if (!chain.empty()) chain[p & (window - 1)] = head[h];
+        head[h] = static_cast<std::uint32_t>(p);
+    };
+
+    auto find = [&] (std::size_t p, std::size_t& offset)
+    {
+        std::size_t best = 0;
+        auto cand = head[hash4(src + p, prm.hash_bits)];
+        for (auto depth = prm.chain_depth; cand != nil && depth; --depth) {
+            if (p - cand > max_offset) break;
+            if (load32(src + cand) == load32(src + p)) {
+                auto len = min_match + common_length(src + cand + min_match,
+                                                     src + p + min_match,
+                                                     n - p - min_match);
+                if (len > best) {
+                    best = len;
+                    offset = p - cand;
+                    if (len >= prm.nice_length || p + len == n) break;
+                }
+            }
+            if (chain.empty()) break;
+            auto next = chain[cand & (window - 1)];
+            if (next == nil || next >= cand) break;
+            cand = next;
+        }
+        return best;
+    };
+
+    std::size_t anchor = 0;
+    std::size_t pos = 0;
+    std::size_t misses = 0;
+    while (pos + min_match <= n) {
+        std::size_t offset = 0;
+        auto len = find(pos, offset);
+        insert(pos);
+        if (len < min_match) {
+            ++misses;
+            pos += prm.accelerate ? 1 + (misses >> 6) : 1;
+            continue;
+        }
+        if (prm.lazy && pos + 1 + min_match <= n) {
+            std::size_t offset2 = 0;
+            auto len2 = find(pos + 1, offset2);
+            if (len2 > len + 1) {       // Байт литералом, совпадение длиннее
+                ++pos;
+                insert(pos);
+                len = len2;
+                offset = offset2;
+            }
+        }
+
+        put_sequence(out, src + anchor, pos - anchor, offset, len);
+        auto end = pos + len;
+        if (prm.chain_depth > 1) {
+            for (auto p = pos + 1; p < end && p + min_match <= n; ++p) insert(p);
+        }
+        else if (end >= 2 && end - 2 > pos && end - 2 + min_match <= n) {
+            insert(end - 2);
+        }
+        pos = anchor = end;
+        misses = 0;
+    }
+    put_sequence(out, src + anchor, n - anchor, 0, 0);
+}
+
+[[noreturn]] inline void corrupt()
+{ throw std::runtime_error{"Compression: поврежденные данные"}; }
+
+inline void decompress_block(const std::byte* src, std::size_t n,
+                             std::byte* dst, std::size_t raw_size)
+{
+    std::size_t ip = 0;
+    std::size_t op = 0;
+    auto read_length = [&] (std::size_t len)
+    {
+        if (len == 15) {
+            for (;;) {
+                if (ip >= n) corrupt();
+                auto b = std::to_integer<std::size_t>(src[ip++]);
+                len += b;
+                if (b != 255) break;
+            }
+        }
+        return len;
+    };
+
+    for (;;) {
+        if (ip >= n) corrupt();
+        auto token = std::to_integer<std::size_t>(src[ip++]);
+        auto lit = read_length(token >> 4);
+        if (lit > n - ip || lit > raw_size - op) corrupt();
+        std::memcpy(dst + op, src + ip, lit);
+        ip += lit;
+        op += lit;
+        if (ip == n) break;
+
+        if (n - ip < 2) corrupt();
+        auto offset = std::to_integer<std::size_t>(src[ip])
+                    | std::to_integer<std::size_t>(src[ip + 1]) << 8;
+        ip += 2;
+        auto len = read_length(token & 15) + min_match;
+        if (offset == 0 || offset > op || len > raw_size - op) corrupt();
+        if (offset >= len) {
+            std::memcpy(dst + op, dst + op - offset, len);
+        }
+        else {                          // Перекрытие: повтор периода
+            for (std::size_t i = 0; i < len; ++i) dst[op + i] = dst[op + i - offset];
+        }
+        op += len;
+    }
+    if (op != raw_size) corrupt();
+}
+
+//------------------------------------------------------------------------------
+// Кадрирование фрагментов
+
+constexpr std::byte magic[4]{std::byte{'E'}, std::byte{'M'},
+                             std::byte{'Z'}, std::byte{'1'}};
+constexpr std::size_t chunk_header = 9;
+constexpr std::size_t max_chunk = std::size_t{64} << 20;
+
+enum class Method : std::uint8_t { stored = 0, lz = 1 };
+
+inline void put_u32(std::byte* p, std::uint32_t v) noexcept
+{
+    for (int i = 0; i < 4; ++i) p[i] = std::byte((v >> (8 * i)) & 0xFF);
+}
+
+inline std::uint32_t get_u32(const std::byte* p) noexcept
+{
+    std::uint32_t v = 0;
+    for (int i = 0; i < 4; ++i) v |= std::to_integer<std::uint32_t>(p[i]) << (8 * i);
+    return v;
+}
+
+// Заголовок и данные одного фрагмента
+inline std::vector<std::byte> encode_chunk(std::vector<std::byte> raw,
+                                           Comp_level level)
+{
+    std::vector<std::byte> out(chunk_header);
+    out.reserve(chunk_header + raw.size() + raw.size() / 255 + 16);
+    compress_block(raw.data(), raw.size(), level, out);
+
+    auto method = Method::lz;
+    if (out.size() - chunk_header >= raw.size()) {     // Не сжалось
+        out.resize(chunk_header);
+        out.insert(out.end(), raw.begin(), raw.end());
+        method = Method::stored;
+    }
+    put_u32(out.data(), static_cast<std::uint32_t>(raw.size()));
+    put_u32(out.data() + 4, static_cast<std::uint32_t>(out.size() - chunk_header));
+    out[8] = std::byte(method);
+    return out;
+}
+
+} // namespace lz_detail
+
+//------------------------------------------------------------------------------
+
+struct Compress_options {
+    Comp_level level{Comp_level::normal};
+    std::size_t chunk_size{256 * 1024};
+    std::size_t threads{0};             // 0 - std::thread::hardware_concurrency
+};
+
+class Compress_stream {
+public:
+    using Sink = std::function<void(std::span<const std::byte>)>;
+
+    explicit Compress_stream(Sink s, Compress_options o = {})
+        : sink{std::move(s)}, opts{o}
+    {
+        if (!opts.chunk_size || opts.chunk_size > lz_detail::max_chunk)
+            throw std::invalid_argument{"Compress_stream: размер фрагмента"};
+        if (!opts.threads) opts.threads = std::thread::hardware_concurrency();
+        if (!opts.threads) opts.threads = 1;
+        buffer.reserve(opts.chunk_size);
+        emit(lz_detail::magic);
+    }
+
+    Compress_stream(const Compress_stream&) = delete;
+    Compress_stream& operator=(const Compress_stream&) = delete;
+
+    ~Compress_stream()
+    {
+        for (auto& f : in_flight) if (f.valid()) f.wait();
+    }
+
+    void write(const void* data, std::size_t n)
+    {
+        auto* p = static_cast<const std::byte*>(data);
+        while (n) {
+            auto k = std::min(n, opts.chunk_size - buffer.size());
+            buffer.insert(buffer.end(), p, p + k);
+            p += k;
+            n -= k;
+            if (buffer.size() == opts.chunk_size) submit();
+        }
+    }
+
+    void write(std::span<const std::byte> data) { write(data.data(), data.size()); }
+
+    template<class T>
+    void write_value(const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        write(&value, sizeof value);
+    }
+
+    // Сжатие остатка, ожидание всех фрагментов и маркер конца потока
+    void finish()
+    {
+        if (finished) return;
+        if (!buffer.empty()) submit();
+        while (!in_flight.empty()) drain_one();
+        std::byte end[lz_detail::chunk_header]{};
+        emit(end);
+        finished = true;
+    }
+
+    std::uint64_t bytes_in() const noexcept { return in_total; }
+    std::uint64_t bytes_out() const noexcept { return out_total; }
+private:
+    void submit()
+    {
+        if (in_flight.size() >= 2 * opts.threads) drain_one();
+        in_total += buffer.size();
+        auto policy = opts.threads > 1 ? std::launch::async : std::launch::deferred;
+        in_flight.push_back(std::async(policy, lz_detail::encode_chunk,
+                                       std::move(buffer), opts.level));
+        buffer = {};
+        buffer.reserve(opts.chunk_size);
+    }
+
+    void drain_one()
+    {
+        auto chunk = in_flight.front().get();
+        in_flight.pop_front();
+        emit(chunk);
+    }
+
+    void emit(std::span<const std::byte> bytes)
+    {
+        out_total += bytes.size();
+        sink(bytes);
+    }
+
+    Sink sink;
+    Compress_options opts;
+    std::vector<std::byte> buffer;
+    std::deque<std::future<std::vector<std::byte>>> in_flight;
+    std::uint64_t in_total{0};
+    std::uint64_t out_total{0};
+    bool finished{false};
+};
+
+//------------------------------------------------------------------------------
+// Распаковка потока, поданного произвольными порциями
+
+class Decompress_stream {
+public:
+    using Sink = std::function<void(std::span<const std::byte>)>;
+
+    explicit Decompress_stream(Sink s) : sink{std::move(s)} {}
+
+    void write(std::span<const std::byte> data)
+    {
+        if (done && !data.empty()) lz_detail::corrupt();
+        pending.insert(pending.end(), data.begin(), data.end());
+        std::size_t pos = 0;
+        while (!done) {
+            auto avail = pending.size() - pos;
+            if (!magic_seen) {
+                if (avail < sizeof lz_detail::magic) break;
+                if (!std::equal(std::begin(lz_detail::magic),
+                                std::end(lz_detail::magic), pending.begin() + pos))
+                    lz_detail::corrupt();
+                magic_seen = true;
+                pos += sizeof lz_detail::magic;
+                continue;
+            }
+            if (avail < lz_detail::chunk_header) break;
+            const auto* h = pending.data() + pos;
+            auto raw_size = lz_detail::get_u32(h);
+            auto stored = lz_detail::get_u32(h + 4);
+            auto method = static_cast<lz_detail::Method>(h[8]);
+            if (raw_size == 0) {
+                done = true;
+                pos += lz_detail::chunk_header;
+                break;
+            }
+            if (raw_size > lz_detail::max_chunk || stored > lz_detail::max_chunk)
+                lz_detail::corrupt();
+            if (avail < lz_detail::chunk_header + stored) break;
+
+            const auto* payload = h + lz_detail::chunk_header;
+            if (method == lz_detail::Method::stored) {
+                if (stored != raw_size) lz_detail::corrupt();
+                sink(std::span<const std::byte>{payload, stored});
+            }
+            else if (method == lz_detail::Method::lz) {
+                out.resize(raw_size);
+                lz_detail::decompress_block(payload, stored, out.data(), raw_size);
+                sink(std::span<const std::byte>{out});
+            }
+            else {
+                lz_detail::corrupt();
+            }
+            pos += lz_detail::chunk_header + stored;
+        }
+        pending.erase(pending.begin(), pending.begin() + pos);
+        if (done && !pending.empty()) lz_detail::corrupt();
+    }
+
+    // Встречен маркер конца потока
+    bool finished() const noexcept { return done; }
+private:
+    Sink sink;
+    std::vector<std::byte> pending;     // Неразобранный хвост входа
+    std::vector<std::byte> out;
+    bool magic_seen{false};
+    bool done{false};
+};
+
+//------------------------------------------------------------------------------
+
+inline std::vector<std::byte> compress_bytes(std::span<const std::byte> data,
+                                             Compress_options o = {})
+{
+    std::vector<std::byte> out;
+    Compress_stream s{[&out] (std::span<const std::byte> b)
+                      { out.insert(out.end(), b.begin(), b.end()); }, o};
+    s.write(data);
+    s.finish();
+    return out;
+}
+
+inline std::vector<std::byte> decompress(std::span<const std::byte> data)
+{
+    std::vector<std::byte> out;
+    Decompress_stream s{[&out] (std::span<const std::byte> b)
+                        { out.insert(out.end(), b.begin(), b.end()); }};
+    s.write(data);
+    if (!s.finished()) lz_detail::corrupt();
+    return out;
+}
+
+// Сжатая копия w; W сериализуется функцией serialize(const W&,
+// Compress_stream&), найденной по ADL
+template<class W>
+std::vector<std::byte> compress(const W& w, Comp_level lev)
+{
+    std::vector<std::byte> out;
+    Compress_options o;
+    o.level = lev;
+    Compress_stream s{[&out] (std::span<const std::byte> b)
+                      { out.insert(out.end(), b.begin(), b.end()); }, o};
+    serialize(w, s);
+    s.finish();
+    return out;
+}
+
+//------------------------------------------------------------------------------
+
+} // namespace em
+
+//------------------------------------------------------------------------------
+
+#endif // COMPRESSION_HPP
+
+//------------------------------------------------------------------------------
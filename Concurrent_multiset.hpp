@@ -0,0 +1,384 @@
+//------------------------------------------------------------------------------
+
+// Упорядоченное мультимножество для log_and_add из разделов 5.4 и 5.5:
+// вставка из многих потоков вместо std::multiset<std::string> names без
+// синхронизации и журнальной записи на каждую вставку
+
+// Вставка кладет элемент в буфер шарда потока (шарды - как у
+// Sharded_counter, каждый под своим мьютексом, обычно без конкуренции).
+// Полный буфер (options.batch элементов) сортируется под мьютексом
+// своего шарда, и до его освобождения берется исключительная
+// блокировка дерева - одна на пачку; затем пачка вливается в B+-дерево
+// (листья до 64 элементов подряд в памяти, связанные для
+// упорядоченного обхода): элементы, попавшие в один лист, дописываются
+// в него разом и сливаются с ним за один проход, переполненный узел
+// делится сразу на нужное число частей. После каждой пачки
+// options.on_batch получает одну отметку времени и размер пачки: журнал
+// пишется раз на пачку, а не на элемент; вызывается вне блокировок,
+// возможно из разных потоков сразу. Запросы (count, for_each, size)
+// сначала вливают недозаполненные буферы, если они есть, и видят все
+// завершенные вставки: буфер, опустевший при вливании в другом потоке,
+// отдан вместе с уже взятой блокировкой дерева, и запрос ждет конца
+// вливания. Запросы выполняются под разделяемой блокировкой параллельно
+// друг с другом
+
+//------------------------------------------------------------------------------
+
+#ifndef CONCURRENT_MULTISET_HPP
+#define CONCURRENT_MULTISET_HPP
+
+//------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <utility>
+#include <vector>
+#include "Sharded_counter.hpp"
+#include "Unique_function.hpp"
+
+//------------------------------------------------------------------------------
+
+namespace em {
+
+//------------------------------------------------------------------------------
+
+struct Concurrent_multiset_options {
+    using Clock = std::chrono::system_clock;
+
+    std::size_t batch{256};                         // Элементов в буфере шарда
+    Unique_function<void(Clock::time_point, std::size_t)> on_batch;
+};
+
+template<class T, class Compare = std::less<>, std::size_t Shards = 32>
+class Concurrent_multiset {
+    static_assert(Shards && (Shards & (Shards - 1)) == 0,
+                  "Число шардов должно быть степенью двойки");
+public:
+    static constexpr std::size_t leaf_max = 64;
+    static constexpr std::size_t fanout = 64;
+
+    explicit Concurrent_multiset(Concurrent_multiset_options o = {}, Compare c = {})
+        : opts{std::move(o)}, comp{std::move(c)}
+    {
+        if (!opts.batch) opts.batch = 1;
+    }
+
+    Concurrent_multiset(const Concurrent_multiset&) = delete;
+    Concurrent_multiset& operator=(const Concurrent_multiset&) = delete;
+
+    void insert(T v)
+    {
+        auto& s = shards[thread_shard_seed() & (Shards - 1)];
+        std::vector<T> full;
+        std::unique_lock<std::shared_mutex> tree;
+        {
+            std::lock_guard<std::mutex> g{s.m};
+            s.buf.push_back(std::move(v));
+            pending.fetch_add(1, std::memory_order_relaxed);
+            if (s.buf.size() < opts.batch) return;
+            full.swap(s.buf);
+            s.buf.reserve(opts.batch);
+            std::stable_sort(full.begin(), full.end(), std::ref(comp));
+            // До освобождения шарда: запрос, заставший буфер пустым,
+            // подождет, пока пачка не окажется в дереве
+            tree = std::unique_lock<std::shared_mutex>{tree_mutex};
+        }
+        merge_sorted(full, std::move(tree));
+    }
+
+    template<class... Args>
+    void emplace(Args&&... args) { insert(T(std::forward<Args>(args)...)); }
+
+    // Готовая пачка вливается сразу, минуя буферы
+    void insert_batch(std::vector<T> batch)
+    {
+        pending.fetch_add(batch.size(), std::memory_order_relaxed);
+        merge(std::move(batch));
+    }
+
+    // Вливание всех буферов шардов
+    void flush()
+    {
+        std::vector<T> all;
+        for (auto& s : shards) {
+            std::lock_guard<std::mutex> g{s.m};
+            std::move(s.buf.begin(), s.buf.end(), std::back_inserter(all));
+            s.buf.clear();
+        }
+        if (!all.empty()) merge(std::move(all));
+    }
+
+    std::size_t size()
+    {
+        sync();
+        std::shared_lock<std::shared_mutex> g{tree_mutex};
+        return n_items;
+    }
+
+    // Элементов, эквивалентных key
+    template<class K>
+    std::size_t count(const K& key)
+    {
+        sync();
+        std::shared_lock<std::shared_mutex> g{tree_mutex};
+        std::size_t n = 0;
+        for (auto* leaf = lower_leaf(key); leaf; leaf = leaf->next) {
+            auto it = std::lower_bound(leaf->keys.begin(), leaf->keys.end(), key, comp);
+            auto end = std::upper_bound(it, leaf->keys.end(), key, comp);
+            n += std::size_t(end - it);
+            if (end != leaf->keys.end()) break;
+        }
+        return n;
+    }
+
+    template<class K>
+    bool contains(const K& key) { return count(key) != 0; }
+
+    // Обход по возрастанию; f не должна обращаться к этому же множеству
+    template<class F>
+    void for_each(F f)
+    {
+        sync();
+        std::shared_lock<std::shared_mutex> g{tree_mutex};
+        for (auto* leaf = first_leaf(); leaf; leaf = leaf->next)
+            for (const auto& v : leaf->keys) f(v);
+    }
+
+    // Обход элементов из [lo, hi) по возрастанию
+    template<class K, class F>
+    void for_each_in(const K& lo, const K& hi, F f)
+    {
+        sync();
+        std::shared_lock<std::shared_mutex> g{tree_mutex};
+        for (auto* leaf = lower_leaf(lo); leaf; leaf = leaf->next) {
+            auto it = std::lower_bound(leaf->keys.begin(), leaf->keys.end(), lo, comp);
+            for (; it != leaf->keys.end(); ++it) {
+                if (!comp(*it, hi)) return;
+                f(*it);
+            }
+        }
+    }
+private:
+    struct Node {
+        explicit Node(bool leaf) : leaf{leaf}
+        {
+            keys.reserve((leaf ? leaf_max : fanout - 1) + 1);
+            if (!leaf) kids.reserve(fanout + 1);
+        }
+
+        bool leaf;
+        std::vector<T> keys;            // Лист - элементы, иначе разделители:
+                                        // keys[i] - первый элемент kids[i + 1]
+        std::vector<Node*> kids;
+        Node* next{nullptr};            // Следующий лист
+    };
+
+    struct alignas(cache_line_size) Shard {
+        std::mutex m;
+        std::vector<T> buf;
+    };
+
+    struct Node_deleter {
+        void operator()(Node* n) const noexcept { destroy(n); }
+    };
+
+    static void destroy(Node* n) noexcept
+    {
+        if (!n) return;
+        for (auto* k : n->kids) destroy(k);
+        delete n;
+    }
+
+    void sync()
+    {
+        if (pending.load(std::memory_order_acquire)) flush();
+    }
+
+    void merge(std::vector<T> batch)
+    {
+        if (batch.empty()) return;
+        std::stable_sort(batch.begin(), batch.end(), std::ref(comp));
+        merge_sorted(batch, std::unique_lock<std::shared_mutex>{tree_mutex});
+    }
+
+    // tree - взятая исключительная блокировка дерева
+    void merge_sorted(std::vector<T>& batch, std::unique_lock<std::shared_mutex> tree)
+    {
+        insert_sorted(batch);
+        n_items += batch.size();
+        pending.fetch_sub(batch.size(), std::memory_order_release);
+        tree.unlock();
+        if (opts.on_batch) opts.on_batch(Concurrent_multiset_options::Clock::now(), batch.size());
+    }
+
+    using Iter = typename std::vector<T>::iterator;
+    using Piece = std::pair<T, Node*>;          // Разделитель и узел за ним
+
+    // Вставка отсортированной пачки, каждый элемент - после всех
+    // эквивалентных
+    void insert_sorted(std::vector<T>& batch)
+    {
+        if (!root) root.reset(new Node{true});
+
+        std::vector<Piece> pieces;
+        insert_range(root.get(), batch.begin(), batch.end(), pieces);
+        while (!pieces.empty()) {               // Новый корень
+            auto* top = new Node{false};
+            top->kids.push_back(root.release());
+            for (auto& [sep, right] : pieces) {
+                top->keys.push_back(std::move(sep));
+                top->kids.push_back(right);
+            }
+            root.reset(top);
+            pieces.clear();
+            cut(top, pieces);
+        }
+    }
+
+    // Вставка непустого отсортированного [first, last) в поддерево n.
+    // Внутренний узел раздает пачку детям справа налево (части, вставленные
+    // в n, не сдвигают детей левее): ребенок последнего элемента - двоичный
+    // поиск среди разделителей, начало его доли - поиск с шагом от конца
+    // пачки. Так верхние уровни сравнивают раз на границу доли, а не на
+    // элемент. Лист сливается со своей долей за один проход. Части
+    // переполненного n дописываются в пустой pieces по возрастанию
+    void insert_range(Node* n, Iter first, Iter last, std::vector<Piece>& pieces)
+    {
+        if (n->leaf) {
+            merge_run(n->keys, first, last);
+        }
+        else {
+            std::vector<Piece> sub;
+            auto keys_end = n->keys.end();
+            while (first != last) {
+                auto i = std::upper_bound(n->keys.begin(), keys_end, *(last - 1), comp)
+                         - n->keys.begin();
+                auto lo = i ? gallop_lower_back(first, last, n->keys[std::size_t(i - 1)])
+                            : first;
+                insert_range(n->kids[std::size_t(i)], lo, last, sub);
+                for (std::size_t j = 0; j < sub.size(); ++j) {
+                    n->keys.insert(n->keys.begin() + i + std::ptrdiff_t(j),
+                                   std::move(sub[j].first));
+                    n->kids.insert(n->kids.begin() + i + std::ptrdiff_t(j) + 1, sub[j].second);
+                }
+                sub.clear();
+                keys_end = n->keys.begin() + (i ? i - 1 : 0);
+                last = lo;
+            }
+        }
+        cut(n, pieces);
+    }
+
+    // lower_bound по [first, last), где *(last - 1) не меньше key, с шагом
+    // от конца, растущим вдвое: доля одного ребенка обычно короткая
+    Iter gallop_lower_back(Iter first, Iter last, const T& key) const
+    {
+        auto hi = last - 1;
+        std::ptrdiff_t step = 1;
+        while (hi - first >= step && !comp(*(hi - step), key)) {
+            hi -= step;
+            step *= 2;
+        }
+        return std::lower_bound(hi - first >= step ? hi - step + 1 : first, hi, key, comp);
+    }
+
+    // Слияние отсортированного [first, last) с листом keys с конца, без
+    // буфера: место каждого элемента пачки - двоичный поиск в еще не
+    // сдвинутой части листа, и каждый элемент листа сдвигается не больше
+    // одного раза; элемент пачки встает после эквивалентных элементов листа
+    void merge_run(std::vector<T>& keys, Iter first, Iter last)
+    {
+        auto old = keys.size();
+        keys.resize(old + std::size_t(last - first));
+        auto rest = keys.begin() + std::ptrdiff_t(old);     // Конец несдвинутой части
+        auto w = keys.end();
+        while (last != first) {
+            --last;
+            auto pos = std::upper_bound(keys.begin(), rest, *last, comp);
+            w = std::move_backward(pos, rest, w);
+            rest = pos;
+            *--w = std::move(*last);
+        }
+    }
+
+    // Переполненный n (возможно, во много раз - большая пачка в один
+    // лист) делится на части примерно поровну, каждая не больше предела;
+    // правые части отрезаются с конца
+    static void cut(Node* n, std::vector<Piece>& pieces)
+    {
+        auto items = [n] { return n->leaf ? n->keys.size() : n->kids.size(); };
+        auto cap = n->leaf ? leaf_max : fanout;
+        for (auto parts = (items() + cap - 1) / cap; parts > 1; --parts)
+            pieces.push_back(split(*n, items() - items() / parts));
+        std::reverse(pieces.begin(), pieces.end());
+    }
+
+    // Отрезание n после первых keep элементов (у листа) или детей (у
+    // внутреннего узла): правая часть и разделитель перед ней
+    static std::pair<T, Node*> split(Node& n, std::size_t keep)
+    {
+        auto* right = new Node{n.leaf};
+        if (n.leaf) {
+            std::move(n.keys.begin() + std::ptrdiff_t(keep), n.keys.end(),
+                      std::back_inserter(right->keys));
+            n.keys.resize(keep);
+            right->next = n.next;
+            n.next = right;
+            return {right->keys.front(), right};
+        }
+        // Разделитель keys[keep - 1] поднимается в родителя
+        T sep = std::move(n.keys[keep - 1]);
+        std::move(n.keys.begin() + std::ptrdiff_t(keep), n.keys.end(),
+                  std::back_inserter(right->keys));
+        right->kids.assign(n.kids.begin() + std::ptrdiff_t(keep), n.kids.end());
+        n.keys.resize(keep - 1);
+        n.kids.resize(keep);
+        return {std::move(sep), right};
+    }
+
+    Node* first_leaf() const noexcept
+    {
+        auto* n = root.get();
+        while (n && !n->leaf) n = n->kids.front();
+        return n;
+    }
+
+    // Лист, с которого начинаются элементы, не меньшие key
+    template<class K>
+    Node* lower_leaf(const K& key) const
+    {
+        auto* n = root.get();
+        while (n && !n->leaf) {
+            auto i = std::lower_bound(n->keys.begin(), n->keys.end(), key, comp) - n->keys.begin();
+            n = n->kids[std::size_t(i)];
+        }
+        return n;
+    }
+
+    Concurrent_multiset_options opts;
+    Compare comp;
+
+    Shard shards[Shards];
+    std::atomic<std::size_t> pending{0};    // В буферах и в сортировке
+
+    std::shared_mutex tree_mutex;
+    std::unique_ptr<Node, Node_deleter> root;
+    std::size_t n_items{0};
+};
+
+//------------------------------------------------------------------------------
+
+} // namespace em
+
+//------------------------------------------------------------------------------
+
+#endif // CONCURRENT_MULTISET_HPP
+
+//------------------------------------------------------------------------------
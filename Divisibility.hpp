@@ -0,0 +1,402 @@
+//------------------------------------------------------------------------------
+
+// Проверка value % divisor == 0 без деления (раздел 6.1)
+
+// Делитель известен только во время выполнения, поэтому один раз
+// вычисляются обратный по модулю 2^W элемент нечетной части делителя и
+// предел: |value| кратно d = d0 * 2^k тогда и только тогда, когда
+// rotr(|value| * inv(d0), k) <= (2^W - 1) / d (Granlund, Montgomery;
+// Hacker's Delight, 10-17). Вместо деления - умножение, сдвиг и сравнение,
+// которые к тому же векторизуются: divisible_mask() проверяет до 64
+// значений за вызов ядрами SSE4/AVX2, а all_divisible() - диапазон целиком,
+// в нескольких потоках и с ранним выходом
+
+//------------------------------------------------------------------------------
+
+#ifndef DIVISIBILITY_HPP
+#define DIVISIBILITY_HPP
+
+//------------------------------------------------------------------------------
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "Simd.hpp"
+
+//------------------------------------------------------------------------------
+
+namespace em {
+
+//------------------------------------------------------------------------------
+
+template<class T>
+class Divisor_test {
+    static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>,
+                  "Нужен целочисленный тип");
+public:
+    // Узкие типы считаются в unsigned: их произведения переполняли бы int
+    using Word = std::conditional_t<(sizeof(T) < sizeof(unsigned)),
+                                    unsigned, std::make_unsigned_t<T>>;
+
+    explicit Divisor_test(T d) : Divisor_test{magnitude(d), d} {}
+
+    // Делитель, заданный модулем (например, НОК нескольких делителей)
+    static Divisor_test from_magnitude(Word m)
+    { return Divisor_test{m, T(1)}; }
+
+    bool operator()(T value) const noexcept
+    { return std::rotr(Word(magnitude(value) * inv), int(k)) <= lim; }
+
+    static Word magnitude(T v) noexcept
+    {
+        if constexpr (std::is_signed_v<T>) {
+            return v < 0 ? Word(Word{0} - Word(v)) : Word(v);
+        }
+        else {
+            return Word(v);
+        }
+    }
+
+    Word divisor_magnitude() const noexcept { return mag; }
+    Word inverse() const noexcept { return inv; }
+    Word limit() const noexcept { return lim; }
+    unsigned shift() const noexcept { return k; }
+private:
+    Divisor_test(Word m, T d)
+        : mag{m}
+    {
+        if (d == 0 || m == 0)
+            throw std::domain_error{"Divisor_test: нулевой делитель"};
+        k = std::countr_zero(m);
+        Word d0 = m >> k;
+        inv = d0;                       // Верно в 3 младших битах
+        for (int i = 0; i < 5; ++i)     // Ньютон: 3 -> 6 -> ... -> 96 битов
+            inv *= Word(2) - d0 * inv;
+        lim = Word(~Word{0}) / m;
+    }
+
+    Word mag;
+    Word inv;
+    Word lim;
+    unsigned k;
+};
+
+//------------------------------------------------------------------------------
+// SIMD-ядра работают в 32-битных дорожках: int и unsigned загружаются как
+// есть, 8- и 16-битные типы расширяются; 64-битные типы проверяются
+// скалярным умножением (в AVX2 нет 64-битного mullo)
+
+namespace divisibility_detail {
+
+template<class T>
+constexpr bool has_simd_lanes = sizeof(T) <= 4;
+
+#ifdef EM_SIMD_X86
+
+template<class T>
+EM_TARGET_SSE4 inline __m128i load4(const T* p)
+{
+    if constexpr (sizeof(T) == 4) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    }
+    else if constexpr (sizeof(T) == 2) {
+        auto v = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));
+        return std::is_signed_v<T> ? _mm_cvtepi16_epi32(v) : _mm_cvtepu16_epi32(v);
+    }
+    else {
+        std::int32_t bytes;
+        std::memcpy(&bytes, p, sizeof bytes);
+        auto v = _mm_cvtsi32_si128(bytes);
+        return std::is_signed_v<T> ? _mm_cvtepi8_epi32(v) : _mm_cvtepu8_epi32(v);
+    }
+}
+
+template<class T>
+EM_TARGET_AVX2 inline __m256i load8(const T* p)
+{
+    if constexpr (sizeof(T) == 4) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    }
+    else if constexpr (sizeof(T) == 2) {
+        auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        return std::is_signed_v<T> ? _mm256_cvtepi16_epi32(v)
+                                   : _mm256_cvtepu16_epi32(v);
+    }
+    else {
+        auto v = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));
+        return std::is_signed_v<T> ? _mm256_cvtepi8_epi32(v)
+                                   : _mm256_cvtepu8_epi32(v);
+    }
+}
+
+// Константы проверки, размноженные по дорожкам
+struct Sse4_test {
+    __m128i inv, lim, right, left;
+
+    template<class T>
+    EM_TARGET_SSE4 explicit Sse4_test(const Divisor_test<T>& t)
+        : inv{_mm_set1_epi32(int(t.inverse()))},
+          lim{_mm_set1_epi32(int(t.limit()))},
+          right{_mm_cvtsi32_si128(int(t.shift()))},
+          left{_mm_cvtsi32_si128(int(32 - t.shift()))} {}
+
+    // 4 бита: дорожка кратна делителю
+    template<class T>
+    EM_TARGET_SSE4 unsigned operator()(const T* p) const
+    {
+        auto v = load4(p);
+        if constexpr (std::is_signed_v<T>) v = _mm_abs_epi32(v);
+        auto q = _mm_mullo_epi32(v, inv);
+        auto r = _mm_or_si128(_mm_srl_epi32(q, right), _mm_sll_epi32(q, left));
+        auto ok = _mm_cmpeq_epi32(_mm_min_epu32(r, lim), r);
+        return unsigned(_mm_movemask_ps(_mm_castsi128_ps(ok)));
+    }
+};
+
+struct Avx2_test {
+    __m256i inv, lim;
+    __m128i right, left;
+
+    template<class T>
+    EM_TARGET_AVX2 explicit Avx2_test(const Divisor_test<T>& t)
+        : inv{_mm256_set1_epi32(int(t.inverse()))},
+          lim{_mm256_set1_epi32(int(t.limit()))},
+          right{_mm_cvtsi32_si128(int(t.shift()))},
+          left{_mm_cvtsi32_si128(int(32 - t.shift()))} {}
+
+    // 8 битов: дорожка кратна делителю
+    template<class T>
+    EM_TARGET_AVX2 unsigned operator()(const T* p) const
+    {
+        auto v = load8(p);
+        if constexpr (std::is_signed_v<T>) v = _mm256_abs_epi32(v);
+        auto q = _mm256_mullo_epi32(v, inv);
+        auto r = _mm256_or_si256(_mm256_srl_epi32(q, right),
+                                 _mm256_sll_epi32(q, left));
+        auto ok = _mm256_cmpeq_epi32(_mm256_min_epu32(r, lim), r);
+        return unsigned(_mm256_movemask_ps(_mm256_castsi256_ps(ok)));
+    }
+};
+
+#endif // EM_SIMD_X86
+
+template<class T>
+std::uint64_t mask_scalar(const Divisor_test<T>& t, const T* p, std::size_t n)
+{
+    std::uint64_t bits = 0;
+    for (std::size_t i = 0; i < n; ++i)
+        bits |= std::uint64_t{t(p[i])} << i;
+    return bits;
+}
+
+template<class T>
+std::size_t find_scalar(const Divisor_test<T>& t, const T* p, std::size_t n)
+{
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)          // Без раннего выхода внутри четверки
+        if (!(t(p[i]) & t(p[i + 1]) & t(p[i + 2]) & t(p[i + 3]))) break;
+    for (; i < n; ++i)
+        if (!t(p[i])) return i;
+    return n;
+}
+
+#ifdef EM_SIMD_X86
+
+template<class T>
+EM_TARGET_SSE4 inline std::uint64_t mask_sse4(const Divisor_test<T>& t,
+                                              const T* p, std::size_t n)
+{
+    const Sse4_test test{t};
+    std::uint64_t bits = 0;
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        bits |= std::uint64_t{test(p + i)} << i;
+    return i == n ? bits : bits | mask_scalar(t, p + i, n - i) << i;
+}
+
+template<class T>
+EM_TARGET_AVX2 inline std::uint64_t mask_avx2(const Divisor_test<T>& t,
+                                              const T* p, std::size_t n)
+{
+    const Avx2_test test{t};
+    std::uint64_t bits = 0;
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        bits |= std::uint64_t{test(p + i)} << i;
+    return i == n ? bits : bits | mask_scalar(t, p + i, n - i) << i;
+}
+
+template<class T>
+EM_TARGET_SSE4 inline std::size_t find_sse4(const Divisor_test<T>& t,
+                                            const T* p, std::size_t n)
+{
+    const Sse4_test test{t};
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        if (auto ok = test(p + i); ok != 0xF)
+            return i + std::countr_one(ok);
+    return i + find_scalar(t, p + i, n - i);
+}
+
+template<class T>
+EM_TARGET_AVX2 inline std::size_t find_avx2(const Divisor_test<T>& t,
+                                            const T* p, std::size_t n)
+{
+    const Avx2_test test{t};
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32) {      // Проверка флага раз на 4 вектора
+        auto ok = test(p + i) & test(p + i + 8)
+                & test(p + i + 16) & test(p + i + 24);
+        if (ok != 0xFF) break;
+    }
+    for (; i + 8 <= n; i += 8)
+        if (auto ok = test(p + i); ok != 0xFF)
+            return i + std::countr_one(ok);
+    return i + find_scalar(t, p + i, n - i);
+}
+
+#endif // EM_SIMD_X86
+
+} // namespace divisibility_detail
+
+// Есть ли для T векторная проверка; без нее любой уровень - скалярный
+template<class T>
+constexpr bool has_simd_divisibility = divisibility_detail::has_simd_lanes<T>;
+
+// Биты кратности элементов p[0..n), n <= 64
+template<class T>
+std::uint64_t divisible_mask(const Divisor_test<T>& t, const T* p, std::size_t n,
+                             Simd_level level = simd_level())
+{
+#ifdef EM_SIMD_X86
+    if constexpr (divisibility_detail::has_simd_lanes<T>) {
+        switch (level) {
+        case Simd_level::avx2: return divisibility_detail::mask_avx2(t, p, n);
+        case Simd_level::sse4: return divisibility_detail::mask_sse4(t, p, n);
+        default: break;
+        }
+    }
+#endif
+    (void)level;
+    return divisibility_detail::mask_scalar(t, p, n);
+}
+
+// Индекс первого некратного элемента или values.size()
+template<class T>
+std::size_t find_not_divisible(std::span<const T> values, const Divisor_test<T>& t,
+                               Simd_level level = simd_level())
+{
+    const T* p = values.data();
+    auto n = values.size();
+#ifdef EM_SIMD_X86
+    if constexpr (divisibility_detail::has_simd_lanes<T>) {
+        switch (level) {
+        case Simd_level::avx2: return divisibility_detail::find_avx2(t, p, n);
+        case Simd_level::sse4: return divisibility_detail::find_sse4(t, p, n);
+        default: break;
+        }
+    }
+#endif
+    (void)level;
+    return divisibility_detail::find_scalar(t, p, n);
+}
+
+//------------------------------------------------------------------------------
+// Аналог std::all_of(..., value % divisor == 0) из work_with_container.
+// Большой диапазон делится между потоками; каждый проверяет свою часть
+// кусками по step элементов и бросает работу, как только другой поток
+// нашел некратное значение
+
+struct Parallel_options {
+    std::size_t threads{0};             // 0 - std::thread::hardware_concurrency
+    std::size_t min_per_thread{1 << 18};// Меньше - не стоит запуска потока
+    std::size_t step{1 << 14};          // Элементов между проверками флага
+};
+
+template<class T>
+bool all_divisible(std::span<const T> values, const Divisor_test<T>& t,
+                   const Parallel_options& opts = {})
+{
+    const auto n = values.size();
+    const auto level = simd_level();
+
+    std::size_t threads = opts.threads ? opts.threads
+                                       : std::thread::hardware_concurrency();
+    auto per_thread = opts.min_per_thread ? opts.min_per_thread : 1;
+    if (threads > (n + per_thread - 1) / per_thread)
+        threads = (n + per_thread - 1) / per_thread;
+    if (threads <= 1) return find_not_divisible(values, t, level) == n;
+
+    std::atomic<bool> failed{false};
+    auto step = opts.step ? opts.step : n;
+    auto check = [&] (std::size_t first, std::size_t last)
+    {
+        for (auto i = first; i < last; i += step) {
+            if (failed.load(std::memory_order_relaxed)) return;
+            auto len = last - i < step ? last - i : step;
+            if (find_not_divisible(values.subspan(i, len), t, level) != len) {
+                failed.store(true, std::memory_order_relaxed);
+                return;
+            }
+        }
+    };
+
+    const auto chunk = (n + threads - 1) / threads;
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    auto spawned = chunk;               // Первый кусок - текущему потоку
+    try {
+        for (; spawned < n; spawned += chunk)
+            workers.emplace_back(check, spawned,
+                                 n - spawned < chunk ? n : spawned + chunk);
+    }
+    catch (const std::system_error&) {} // Остаток проверим сами
+
+    check(0, chunk);
+    if (spawned < n) check(spawned, n);
+    for (auto& w : workers) w.join();
+    return !failed.load();
+}
+
+template<class T>
+bool all_divisible(std::span<const T> values, T divisor,
+                   const Parallel_options& opts = {})
+{ return all_divisible(values, Divisor_test<T>{divisor}, opts); }
+
+// Контейнер из work_with_container: непрерывные - через SIMD и потоки,
+// остальные (std::list, std::set...) - последовательно, но без деления
+template<class C>
+bool all_divisible(const C& container, typename C::value_type divisor,
+                   const Parallel_options& opts = {})
+{
+    using Cont_elem_t = typename C::value_type;
+    if constexpr (std::ranges::contiguous_range<const C&>) {
+        return all_divisible(std::span<const Cont_elem_t>{container},
+                             Divisor_test<Cont_elem_t>{divisor}, opts);
+    }
+    else {
+        const Divisor_test<Cont_elem_t> t{divisor};
+        for (const auto& value : container)
+            if (!t(value)) return false;
+        return true;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+} // namespace em
+
+//------------------------------------------------------------------------------
+
+#endif // DIVISIBILITY_HPP
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,267 @@
+//------------------------------------------------------------------------------
+
+// Цикл событий для сопрограмм Task: таймеры в духе set_alarm из раздела
+// 6.4 (co_await loop.sleep_until(t) вместо обратного вызова) без потока
+// на каждую ожидающую операцию
+
+// Готовые к продолжению сопрограммы стоят в очереди, а спящие - в
+// Timing_wheel с тиком options.tick (срок округляется вверх, раньше
+// времени сопрограмма не просыпается), поэтому тысячи одновременно
+// ожидающих задач стоят по узлу колеса каждая. run() выполняет цикл в
+// вызывающем потоке, run(n) - еще в n - 1 дополнительных: любая готовая
+// сопрограмма продолжается в любом из них. Цикл завершается, когда не
+// остается задач, запущенных spawn(). Первое исключение из такой задачи
+// выбрасывается из run() после ее завершения
+
+//------------------------------------------------------------------------------
+
+#ifndef EVENT_LOOP_HPP
+#define EVENT_LOOP_HPP
+
+//------------------------------------------------------------------------------
+
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "Slab_pool.hpp"
+#include "Task.hpp"
+#include "Timing_wheel.hpp"
+
+//------------------------------------------------------------------------------
+
+namespace em {
+
+//------------------------------------------------------------------------------
+
+struct Event_loop_options {
+    std::chrono::steady_clock::duration tick{std::chrono::milliseconds{1}};
+};
+
+class Event_loop {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Time = Clock::time_point;
+    using Duration = Clock::duration;
+
+    explicit Event_loop(Event_loop_options o = {})
+        : opts{o}, epoch{Clock::now()} {}
+
+    Event_loop(const Event_loop&) = delete;
+    Event_loop& operator=(const Event_loop&) = delete;
+
+    // co_await loop.schedule(): продолжение в потоке цикла; из
+    // сопрограммы цикла - уступить очередь другим
+    auto schedule() noexcept
+    {
+        struct Awaiter {
+            Event_loop* loop;
+
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> h) { loop->enqueue(h); }
+            void await_resume() const noexcept {}
+        };
+        return Awaiter{this};
+    }
+
+    // co_await loop.sleep_until(t): продолжение не раньше t
+    auto sleep_until(Time t) noexcept
+    {
+        struct Awaiter {
+            Event_loop* loop;
+            Time t;
+
+            bool await_ready() const noexcept { return t <= Clock::now(); }
+            void await_suspend(std::coroutine_handle<> h) { loop->add_timer(t, h); }
+            void await_resume() const noexcept {}
+        };
+        return Awaiter{this, t};
+    }
+
+    auto sleep_for(Duration d) noexcept { return sleep_until(Clock::now() + d); }
+
+    // Запуск задачи, за завершением которой следит цикл
+    void spawn(Task<void> task)
+    {
+        auto d = detach(std::move(task));
+        {
+            std::lock_guard<std::mutex> g{m};
+            ++alive;
+        }
+        enqueue(d.h);
+    }
+
+    // Выполнение цикла, пока есть задачи от spawn(), в вызывающем
+    // потоке и в threads - 1 дополнительных
+    void run(std::size_t threads = 1)
+    {
+        std::vector<std::thread> extra;
+        for (std::size_t i = 1; i < threads; ++i)
+            extra.emplace_back([this] { work(); });
+        work();
+        for (auto& t : extra) t.join();
+
+        std::lock_guard<std::mutex> g{m};
+        if (auto e = std::exchange(error, nullptr)) std::rethrow_exception(e);
+    }
+
+    // Выполнение task до завершения вместе со всеми задачами цикла
+    template<class T>
+    T run(Task<T> task, std::size_t threads = 1)
+    {
+        if constexpr (std::is_void_v<T>) {
+            spawn(std::move(task));
+            run(threads);
+        }
+        else {
+            std::optional<T> result;
+            spawn(store(std::move(task), result));
+            run(threads);
+            return std::move(*result);
+        }
+    }
+
+    // Ожидающие таймера сопрограммы
+    std::size_t sleeping() const
+    {
+        std::lock_guard<std::mutex> g{m};
+        return wheel.size();
+    }
+private:
+    using Tick = Timing_wheel<std::coroutine_handle<>>::Tick;
+
+    // Задача, уничтожающая свой кадр сама по завершении
+    struct Detached {
+        struct promise_type : Slab_allocated {
+            Detached get_return_object() noexcept
+            { return {std::coroutine_handle<promise_type>::from_promise(*this)}; }
+
+            std::suspend_always initial_suspend() const noexcept { return {}; }
+            std::suspend_never final_suspend() const noexcept { return {}; }
+            void return_void() const noexcept {}
+            void unhandled_exception() const noexcept { std::terminate(); }
+        };
+
+        std::coroutine_handle<> h;
+    };
+
+    Detached detach(Task<void> task)
+    {
+        std::exception_ptr e;
+        try {
+            co_await task;
+        }
+        catch (...) {
+            e = std::current_exception();
+        }
+        finished(std::move(e));
+    }
+
+    template<class T>
+    static Task<void> store(Task<T> task, std::optional<T>& result)
+    { result.emplace(co_await task); }
+
+    void finished(std::exception_ptr e)
+    {
+        bool last;
+        {
+            std::lock_guard<std::mutex> g{m};
+            if (e && !error) error = std::move(e);
+            last = --alive == 0;
+        }
+        if (last) cv.notify_all();
+    }
+
+    void enqueue(std::coroutine_handle<> h)
+    {
+        {
+            std::lock_guard<std::mutex> g{m};
+            ready.push_back(h);
+        }
+        cv.notify_one();
+    }
+
+    // Округление вверх: сопрограмма не просыпается раньше t
+    Tick tick_of(Time t) const noexcept
+    {
+        if (t <= epoch) return 0;
+        return Tick((t - epoch + opts.tick - Duration{1}) / opts.tick);
+    }
+
+    Time time_of(Tick tick) const noexcept
+    { return epoch + opts.tick * static_cast<Duration::rep>(tick); }
+
+    Tick elapsed_ticks() const noexcept
+    { return Tick((Clock::now() - epoch) / opts.tick); }
+
+    void add_timer(Time t, std::coroutine_handle<> h)
+    {
+        auto tick = tick_of(t);
+        bool earlier;
+        {
+            std::lock_guard<std::mutex> g{m};
+            wheel.schedule(tick, h);
+            earlier = !sleeping_until || tick < sleeping_until;
+        }
+        if (earlier) cv.notify_one();
+    }
+
+    void work()
+    {
+        std::unique_lock<std::mutex> lock{m};
+        while (alive) {
+            if (!wheel.empty())
+                wheel.advance(elapsed_ticks(), [this] (Tick, std::coroutine_handle<>&& h)
+                { ready.push_back(h); });
+
+            if (!ready.empty()) {
+                auto h = ready.front();
+                ready.pop_front();
+                if (!ready.empty()) cv.notify_one();     // Работа и другим
+                lock.unlock();
+                h.resume();
+                lock.lock();
+                continue;
+            }
+
+            auto bound = wheel.next_bound();
+            if (bound && (!sleeping_until || *bound < sleeping_until)) {
+                sleeping_until = *bound;        // Таймеры ждет один поток,
+                cv.wait_until(lock, time_of(*bound));
+                sleeping_until = 0;             // остальные - очереди
+            }
+            else {
+                cv.wait(lock);
+            }
+        }
+    }
+
+    Event_loop_options opts;
+    Time epoch;
+
+    mutable std::mutex m;
+    std::condition_variable cv;
+    std::deque<std::coroutine_handle<>> ready;
+    Timing_wheel<std::coroutine_handle<>> wheel;
+    Tick sleeping_until{0};             // 0 - таймеры никто не ждет
+    std::size_t alive{0};
+    std::exception_ptr error;
+};
+
+//------------------------------------------------------------------------------
+
+} // namespace em
+
+//------------------------------------------------------------------------------
+
+#endif // EVENT_LOOP_HPP
+
+//------------------------------------------------------------------------------
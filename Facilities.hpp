@@ -23,7 +23,11 @@
 class Widget;
 
 template<class T>
-void make_log_entry(T&);
+void make_log_entry(T&);    // Асинхронная реализация в Async_log.hpp
+
+//------------------------------------------------------------------------------
+
+#include "Async_log.hpp"
 
 //------------------------------------------------------------------------------
 
@@ -0,0 +1,136 @@
+//------------------------------------------------------------------------------
+
+// Пакетное вычисление фильтров Filter_container из раздела 6.1
+
+// Filter_container - это std::vector<std::function<bool(int)>>, и проход
+// N фильтров по M значениям стоит N*M косвенных вызовов. Filter_engine
+// один раз разбирает контейнер: фильтры-делители (em::Divisible_by,
+// распознаются через std::function::target) сливаются по НОК и
+// проверяются SIMD-ядрами Divisibility.hpp блоками по 64 значения; прочие
+// фильтры вызываются только для значений, которые прошли все делители.
+// Значение отбирается, если его пропускают все фильтры; фильтры считаются
+// чистыми функциями, порядок их вызова не сохраняется
+
+//------------------------------------------------------------------------------
+
+#ifndef FILTER_ENGINE_HPP
+#define FILTER_ENGINE_HPP
+
+//------------------------------------------------------------------------------
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <vector>
+#include "Bitmask.hpp"
+#include "Divisibility.hpp"
+
+//------------------------------------------------------------------------------
+
+namespace em {
+
+//------------------------------------------------------------------------------
+
+// Фильтр value % divisor == 0 из add_divisor_filter, который
+// Filter_engine узнает в std::function
+struct Divisible_by {
+    int divisor;
+
+    bool operator()(int value) const { return value % divisor == 0; }
+};
+
+//------------------------------------------------------------------------------
+
+class Filter_engine {
+public:
+    using Filter = std::function<bool(int)>;
+
+    explicit Filter_engine(const std::vector<Filter>& filters)
+    {
+        std::uint64_t lcm = 1;
+        for (const auto& f : filters) {
+            if (auto* d = f.target<Divisible_by>()) {
+                std::uint64_t m = Divisor_test<int>::magnitude(d->divisor);
+                if (m == 0)
+                    throw std::domain_error{"Divisible_by: нулевой делитель"};
+                auto merged = std::lcm(lcm, m);
+                if (merged > ~std::uint32_t{0}) {   // Не влезает в слово:
+                    flush(lcm);                     // отдельное ядро
+                    merged = m;
+                }
+                lcm = merged;
+            }
+            else {
+                generic.push_back(f);
+            }
+        }
+        flush(lcm);
+    }
+
+    std::size_t kernel_count() const noexcept { return divisors.size(); }
+    std::size_t generic_count() const noexcept { return generic.size(); }
+
+    // out.size() == values.size(); бит i - values[i] прошло все фильтры
+    void select(std::span<const int> values, Bitmask& out) const
+    {
+        out.resize(values.size());
+        const auto level = simd_level();
+        for (std::size_t w = 0; w < out.word_count(); ++w) {
+            auto first = w * Bitmask::word_bits;
+            const int* block = values.data() + first;
+            auto n = values.size() - first;
+            if (n > Bitmask::word_bits) n = Bitmask::word_bits;
+
+            auto bits = out.valid_bits(w);
+            for (const auto& d : divisors) {
+                bits &= divisible_mask(d, block, n, level);
+                if (!bits) break;
+            }
+            for (const auto& f : generic) {
+                for (auto rest = bits; rest; rest &= rest - 1) {
+                    auto i = std::countr_zero(rest);
+                    if (!f(block[i])) bits &= ~(std::uint64_t{1} << i);
+                }
+                if (!bits) break;
+            }
+            out.data()[w] = bits;
+        }
+    }
+
+    Bitmask select(std::span<const int> values) const
+    {
+        Bitmask out;
+        select(values, out);
+        return out;
+    }
+
+    std::vector<std::uint32_t> select_indices(std::span<const int> values) const
+    { return select(values).indices(); }
+
+    std::size_t count(std::span<const int> values) const
+    { return select(values).count(); }
+private:
+    void flush(std::uint64_t lcm)
+    {
+        if (lcm != 1)                   // Делитель 1 пропускает все
+            divisors.push_back(Divisor_test<int>::from_magnitude(
+                                   static_cast<unsigned>(lcm)));
+    }
+
+    std::vector<Divisor_test<int>> divisors;
+    std::vector<Filter> generic;
+};
+
+//------------------------------------------------------------------------------
+
+} // namespace em
+
+//------------------------------------------------------------------------------
+
+#endif // FILTER_ENGINE_HPP
+
+//------------------------------------------------------------------------------
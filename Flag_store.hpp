@@ -0,0 +1,281 @@
+//------------------------------------------------------------------------------
+
+// Столбцовое хранилище флагов Widget (is_validated, is_processed,
+// is_archived из раздела 6.2) для массовых запросов вместо вызова
+// Is_val_and_arch через указатель для каждого объекта
+
+// Каждый флаг - отдельный Bitmask по всей совокупности виджетов, а запрос
+// "validated И archived И НЕ processed" - Flag_query с требуемыми и
+// исключенными флагами. count() и select() проходят столбцы за один
+// проход словами по 64 бита: AND/ANDNOT и подсчет битов ядрами SSE4/AVX2
+// (popcount - по таблице полубайтов через pshufb, Mula), без обращения
+// к самим объектам. assign() переводит все отобранные виджеты в новое
+// состояние теми же операциями над словами
+
+//------------------------------------------------------------------------------
+
+#ifndef FLAG_STORE_HPP
+#define FLAG_STORE_HPP
+
+//------------------------------------------------------------------------------
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include "Bitmask.hpp"
+#include "Simd.hpp"
+
+//------------------------------------------------------------------------------
+
+namespace em {
+
+//------------------------------------------------------------------------------
+
+enum class Widget_flag { validated, processed, archived, count };
+
+// Набор требуемых (with) и исключенных (without) флагов
+template<class Flag>
+class Flag_query {
+public:
+    constexpr Flag_query with(Flag f) const noexcept
+    {
+        auto q = *this;
+        q.required |= bit(f);
+        return q;
+    }
+
+    constexpr Flag_query without(Flag f) const noexcept
+    {
+        auto q = *this;
+        q.excluded |= bit(f);
+        return q;
+    }
+
+    constexpr std::uint32_t required_bits() const noexcept { return required; }
+    constexpr std::uint32_t excluded_bits() const noexcept { return excluded; }
+private:
+    static constexpr std::uint32_t bit(Flag f) noexcept
+    { return std::uint32_t{1} << static_cast<unsigned>(f); }
+
+    std::uint32_t required{0};
+    std::uint32_t excluded{0};
+};
+
+//------------------------------------------------------------------------------
+// Ядра: слово результата = AND with-столбцов AND NOT without-столбцов
+
+namespace flag_detail {
+
+constexpr std::size_t max_columns = 32;
+
+struct Plan {
+    const std::uint64_t* with[max_columns];
+    const std::uint64_t* without[max_columns];
+    std::size_t n_with{0};
+    std::size_t n_without{0};
+};
+
+inline std::uint64_t combine(const Plan& p, std::size_t w) noexcept
+{
+    auto acc = p.n_with ? p.with[0][w] : ~std::uint64_t{0};
+    for (std::size_t c = 1; c < p.n_with; ++c) acc &= p.with[c][w];
+    for (std::size_t c = 0; c < p.n_without; ++c) acc &= ~p.without[c][w];
+    return acc;
+}
+
+// Слова [from, to); out == nullptr - только подсчет
+inline std::size_t run_scalar(const Plan& p, std::size_t from, std::size_t to,
+                              std::uint64_t* out) noexcept
+{
+    std::size_t total = 0;
+    for (std::size_t w = from; w < to; ++w) {
+        auto acc = combine(p, w);
+        if (out) out[w] = acc;
+        total += std::popcount(acc);
+    }
+    return total;
+}
+
+#ifdef EM_SIMD_X86
+
+EM_TARGET_SSE4 inline __m128i load2(const std::uint64_t* q) noexcept
+{ return _mm_loadu_si128(reinterpret_cast<const __m128i*>(q)); }
+
+EM_TARGET_AVX2 inline __m256i load4(const std::uint64_t* q) noexcept
+{ return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(q)); }
+
+EM_TARGET_SSE4 inline std::size_t run_sse4(const Plan& p, std::size_t n,
+                                           std::uint64_t* out) noexcept
+{
+    using V = __m128i;
+    const auto lut = _mm_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const auto low = _mm_set1_epi8(0x0F);
+
+    auto sums = _mm_setzero_si128();
+    std::size_t w = 0;
+    for (; w + 2 <= n; w += 2) {
+        auto acc = p.n_with ? load2(p.with[0] + w) : _mm_set1_epi8(-1);
+        for (std::size_t c = 1; c < p.n_with; ++c)
+            acc = _mm_and_si128(acc, load2(p.with[c] + w));
+        for (std::size_t c = 0; c < p.n_without; ++c)
+            acc = _mm_andnot_si128(load2(p.without[c] + w), acc);
+        if (out) _mm_storeu_si128(reinterpret_cast<V*>(out + w), acc);
+
+        auto cnt = _mm_add_epi8(
+                _mm_shuffle_epi8(lut, _mm_and_si128(acc, low)),
+                _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(acc, 4), low)));
+        sums = _mm_add_epi64(sums, _mm_sad_epu8(cnt, _mm_setzero_si128()));
+    }
+    alignas(16) std::uint64_t lanes[2];
+    _mm_store_si128(reinterpret_cast<V*>(lanes), sums);
+    return std::size_t(lanes[0] + lanes[1]) + run_scalar(p, w, n, out);
+}
+
+EM_TARGET_AVX2 inline std::size_t run_avx2(const Plan& p, std::size_t n,
+                                           std::uint64_t* out) noexcept
+{
+    using V = __m256i;
+    const auto lut = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                      0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const auto low = _mm256_set1_epi8(0x0F);
+
+    auto sums = _mm256_setzero_si256();
+    std::size_t w = 0;
+    for (; w + 4 <= n; w += 4) {
+        auto acc = p.n_with ? load4(p.with[0] + w) : _mm256_set1_epi8(-1);
+        for (std::size_t c = 1; c < p.n_with; ++c)
+            acc = _mm256_and_si256(acc, load4(p.with[c] + w));
+        for (std::size_t c = 0; c < p.n_without; ++c)
+            acc = _mm256_andnot_si256(load4(p.without[c] + w), acc);
+        if (out) _mm256_storeu_si256(reinterpret_cast<V*>(out + w), acc);
+
+        auto cnt = _mm256_add_epi8(
+                _mm256_shuffle_epi8(lut, _mm256_and_si256(acc, low)),
+                _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(acc, 4), low)));
+        sums = _mm256_add_epi64(sums, _mm256_sad_epu8(cnt, _mm256_setzero_si256()));
+    }
+    alignas(32) std::uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<V*>(lanes), sums);
+    return std::size_t(lanes[0] + lanes[1] + lanes[2] + lanes[3])
+         + run_scalar(p, w, n, out);
+}
+
+#endif // EM_SIMD_X86
+
+// Все слова, кроме последнего: у него отсекаются биты за size()
+inline std::size_t run(const Plan& p, std::size_t n, std::uint64_t tail,
+                       std::uint64_t* out) noexcept
+{
+    if (!n) return 0;
+    std::size_t total = 0;
+    switch (simd_level()) {
+#ifdef EM_SIMD_X86
+    case Simd_level::avx2: total = run_avx2(p, n - 1, out); break;
+    case Simd_level::sse4: total = run_sse4(p, n - 1, out); break;
+#endif
+    default:               total = run_scalar(p, 0, n - 1, out); break;
+    }
+    auto last = combine(p, n - 1) & tail;
+    if (out) out[n - 1] = last;
+    return total + std::popcount(last);
+}
+
+} // namespace flag_detail
+
+//------------------------------------------------------------------------------
+
+template<class Flag, std::size_t N = static_cast<std::size_t>(Flag::count)>
+class Flag_store {
+public:
+    static_assert(N <= flag_detail::max_columns);
+
+    using Query = Flag_query<Flag>;
+
+    explicit Flag_store(std::size_t n = 0) { resize(n); }
+
+    std::size_t size() const noexcept { return n_items; }
+
+    void resize(std::size_t n)
+    {
+        for (auto& c : columns) c.resize(n);
+        n_items = n;
+    }
+
+    // Новый элемент с установленными флагами set; его индекс
+    std::size_t push_back(std::initializer_list<Flag> set = {})
+    {
+        resize(n_items + 1);
+        for (auto f : set) columns[index(f)].set(n_items - 1);
+        return n_items - 1;
+    }
+
+    bool test(std::size_t i, Flag f) const noexcept { return columns[index(f)].test(i); }
+    void set(std::size_t i, Flag f, bool value = true) noexcept
+    { columns[index(f)].set(i, value); }
+
+    // Столбец целиком: для массовой загрузки и операций Bitmask
+    const Bitmask& column(Flag f) const noexcept { return columns[index(f)]; }
+    Bitmask& column(Flag f) noexcept { return columns[index(f)]; }
+
+    std::size_t count(Query q) const noexcept
+    { return flag_detail::run(plan(q), words(), tail(), nullptr); }
+
+    // out[i] - элемент i удовлетворяет запросу; число таких элементов
+    std::size_t select(Query q, Bitmask& out) const
+    {
+        out.resize(n_items);
+        return flag_detail::run(plan(q), words(), tail(), out.data());
+    }
+
+    Bitmask select(Query q) const
+    {
+        Bitmask out;
+        select(q, out);
+        return out;
+    }
+
+    // Флаг f = value у всех элементов, удовлетворяющих запросу;
+    // число таких элементов
+    std::size_t assign(Query q, Flag f, bool value = true)
+    {
+        Bitmask hits;
+        auto n = select(q, hits);
+        if (value) columns[index(f)] |= hits;
+        else columns[index(f)].and_not(hits);
+        return n;
+    }
+private:
+    static constexpr std::size_t index(Flag f) noexcept
+    { return static_cast<std::size_t>(f); }
+
+    std::size_t words() const noexcept { return columns[0].word_count(); }
+    std::uint64_t tail() const noexcept
+    { return words() ? columns[0].valid_bits(words() - 1) : 0; }
+
+    flag_detail::Plan plan(Query q) const noexcept
+    {
+        flag_detail::Plan p;
+        for (std::size_t c = 0; c < N; ++c) {
+            if (q.required_bits() >> c & 1) p.with[p.n_with++] = columns[c].data();
+            if (q.excluded_bits() >> c & 1) p.without[p.n_without++] = columns[c].data();
+        }
+        return p;
+    }
+
+    std::array<Bitmask, N> columns;
+    std::size_t n_items{0};
+};
+
+using Widget_flags = Flag_store<Widget_flag>;
+
+//------------------------------------------------------------------------------
+
+} // namespace em
+
+//------------------------------------------------------------------------------
+
+#endif // FLAG_STORE_HPP
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,349 @@
+//------------------------------------------------------------------------------
+
+// Контейнер в духе colony/hive для реестра виджетов вместо
+// std::list<std::shared_ptr<Widget>> ptrs из раздела 8.2
+
+// Элементы лежат в блоках (64 ячейки в первом, далее емкость удваивается
+// до 8192), а не в отдельном узле на элемент, и не перемещаются, пока не
+// удалены: адреса и итераторы остальных элементов стабильны. Удаление -
+// O(1): ячейка отмечается в поле пропусков (jump-counting skip field: в
+// первой и последней ячейке каждой серии удаленных - длина серии), и
+// обход перескакивает серию за один шаг, проходя блок в порядке памяти.
+// Серии удаленных ячеек блока связаны в список через память самих ячеек,
+// вставка сначала занимает их и только потом новые ячейки. Удалители
+// хранимых объектов (kill_widget у shared_ptr) вызываются как обычно.
+// Новые ячейки берутся из первого блока, не заполненного до конца, так
+// что после clear() блоки заполняются заново с первого, а не растет
+// новый. Память блоков не возвращается до уничтожения контейнера
+
+//------------------------------------------------------------------------------
+
+#ifndef HIVE_HPP
+#define HIVE_HPP
+
+//------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+namespace em {
+
+//------------------------------------------------------------------------------
+
+template<class T>
+class Hive {
+    using Index = std::uint16_t;
+    static constexpr Index none = 0xFFFF;
+
+    // Ячейка: элемент или звено списка серий удаленных
+    union Slot {
+        Slot() noexcept {}
+        ~Slot() {}
+
+        T value;
+        struct { Index prev, next; } links;
+    };
+
+    struct Block {
+        explicit Block(std::size_t cap)
+            : slots{new Slot[cap]}, skip{new Index[cap + 1]{}}, cap{cap} {}
+
+        std::unique_ptr<Slot[]> slots;
+        std::unique_ptr<Index[]> skip;  // 0 - занята или еще не использована
+        std::size_t cap;
+        std::size_t high{0};            // Ячейки [high, cap) еще не использовались
+        std::size_t size{0};
+        Index free_head{none};          // Первая серия удаленных
+        Block* next{nullptr};
+
+        // Первая занятая ячейка, начиная с i (i - занятая или начало серии)
+        std::size_t skip_from(std::size_t i) const noexcept { return i + skip[i]; }
+    };
+
+    template<bool Const>
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, const T*, T*>;
+        using reference = std::conditional_t<Const, const T&, T&>;
+
+        Iterator() noexcept = default;
+
+        template<bool C = Const, class = std::enable_if_t<C>>
+        Iterator(const Iterator<false>& rhs) noexcept : b{rhs.b}, i{rhs.i} {}
+
+        reference operator*() const noexcept { return b->slots[i].value; }
+        pointer operator->() const noexcept { return &b->slots[i].value; }
+
+        Iterator& operator++() noexcept
+        {
+            i = b->skip_from(i + 1);
+            if (i >= b->high) *this = first_in(b->next);
+            return *this;
+        }
+
+        Iterator operator++(int) noexcept
+        {
+            auto old = *this;
+            ++*this;
+            return old;
+        }
+
+        friend bool operator==(const Iterator& a, const Iterator& c) noexcept
+        { return a.b == c.b && a.i == c.i; }
+    private:
+        friend class Hive;
+        template<bool> friend class Iterator;
+
+        Iterator(Block* b, std::size_t i) noexcept : b{b}, i{i} {}
+
+        // Первый элемент блока b или следующих; end(), если их нет
+        static Iterator first_in(Block* b) noexcept
+        {
+            for (; b; b = b->next) {
+                auto i = b->skip_from(0);
+                if (i < b->high) return {b, i};
+            }
+            return {};
+        }
+
+        Block* b{nullptr};
+        std::size_t i{0};
+    };
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    static constexpr std::size_t first_block = 64;
+    static constexpr std::size_t max_block = 8192;
+
+    Hive() noexcept = default;
+
+    Hive(Hive&& rhs) noexcept
+        : blocks{std::move(rhs.blocks)}, with_free{std::move(rhs.with_free)},
+          fill{std::exchange(rhs.fill, 0)}, count{std::exchange(rhs.count, 0)} {}
+
+    Hive& operator=(Hive&& rhs) noexcept
+    {
+        if (this != &rhs) {
+            clear();
+            blocks = std::move(rhs.blocks);
+            with_free = std::move(rhs.with_free);
+            fill = std::exchange(rhs.fill, 0);
+            count = std::exchange(rhs.count, 0);
+        }
+        return *this;
+    }
+
+    Hive(const Hive&) = delete;
+    Hive& operator=(const Hive&) = delete;
+
+    ~Hive() { clear(); }
+
+    std::size_t size() const noexcept { return count; }
+    bool empty() const noexcept { return count == 0; }
+
+    std::size_t capacity() const noexcept
+    {
+        std::size_t n = 0;
+        for (const auto& b : blocks) n += b->cap;
+        return n;
+    }
+
+    template<class... Args>
+    iterator emplace(Args&&... args)
+    {
+        Block* b;
+        std::size_t i;
+        bool reused = !with_free.empty();
+        if (reused) {
+            b = with_free.back();
+            i = take_run(*b);
+            if (b->free_head == none) with_free.pop_back();
+        }
+        else {
+            while (fill < blocks.size() && blocks[fill]->high == blocks[fill]->cap) ++fill;
+            if (fill == blocks.size()) add_block();
+            b = blocks[fill].get();
+            i = b->high;
+        }
+
+        try {
+            std::construct_at(&b->slots[i].value, std::forward<Args>(args)...);
+        }
+        catch (...) {
+            if (reused) release(*b, i);
+            throw;
+        }
+        if (!reused) ++b->high;
+        ++b->size;
+        ++count;
+        return {b, i};
+    }
+
+    iterator insert(const T& v) { return emplace(v); }
+    iterator insert(T&& v) { return emplace(std::move(v)); }
+
+    // Следующий за pos элемент
+    iterator erase(const_iterator pos) noexcept
+    {
+        iterator it{pos.b, pos.i};
+        auto next = std::next(it);
+        std::destroy_at(&it.b->slots[it.i].value);
+        release(*it.b, it.i);
+        --it.b->size;
+        --count;
+        return next;
+    }
+
+    void clear() noexcept
+    {
+        for (auto& b : blocks) {
+            for (auto i = b->skip_from(0); i < b->high; i = b->skip_from(i + 1))
+                std::destroy_at(&b->slots[i].value);
+            std::fill_n(b->skip.get(), b->cap + 1, Index{0});
+            b->high = 0;
+            b->size = 0;
+            b->free_head = none;
+        }
+        with_free.clear();
+        fill = 0;
+        count = 0;
+    }
+
+    iterator begin() noexcept { return iterator::first_in(head()); }
+    iterator end() noexcept { return {}; }
+    const_iterator begin() const noexcept { return const_iterator::first_in(head()); }
+    const_iterator end() const noexcept { return {}; }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    // Обход в порядке памяти с упреждающей загрузкой следующего блока
+    template<class F>
+    void for_each(F f)
+    {
+        for (auto* b = head(); b; b = b->next) {
+            if (auto* n = b->next) {
+                __builtin_prefetch(n->skip.get());
+                __builtin_prefetch(n->slots.get());
+            }
+            for (auto i = b->skip_from(0); i < b->high; i = b->skip_from(i + 1))
+                f(b->slots[i].value);
+        }
+    }
+private:
+    Block* head() const noexcept { return blocks.empty() ? nullptr : blocks.front().get(); }
+
+    void add_block()
+    {
+        auto cap = std::clamp(capacity(), first_block, max_block);
+        blocks.push_back(std::make_unique<Block>(cap));
+        if (blocks.size() > 1) blocks[blocks.size() - 2]->next = blocks.back().get();
+    }
+
+    // Ячейка i блока b свободна: слияние с соседними сериями
+    void release(Block& b, std::size_t i) noexcept
+    {
+        auto* skip = b.skip.get();
+        std::size_t left = i > 0 ? skip[i - 1] : 0;     // Длина серии слева
+        std::size_t right = skip[i + 1];                // Длина серии справа
+        bool had_free = b.free_head != none;
+
+        if (!left && !right) {
+            skip[i] = 1;
+            link_run(b, i);
+        }
+        else if (!right) {
+            auto n = Index(left + 1);
+            skip[i - left] = n;
+            skip[i] = n;
+        }
+        else if (!left) {
+            auto n = Index(right + 1);
+            skip[i] = n;
+            skip[i + right] = n;
+            replace_run(b, i + 1, i);
+        }
+        else {
+            auto n = Index(left + right + 1);
+            skip[i - left] = n;
+            skip[i + right] = n;
+            skip[i] = 1;                                // Внутри серии - не 0
+            unlink_run(b, i + 1);
+        }
+        if (!had_free) with_free.push_back(&b);
+    }
+
+    // Первая ячейка первой серии удаленных; остаток серии остается в списке
+    std::size_t take_run(Block& b) noexcept
+    {
+        auto* skip = b.skip.get();
+        std::size_t s = b.free_head;
+        std::size_t n = skip[s];
+        if (n > 1) {
+            skip[s + 1] = Index(n - 1);
+            skip[s + n - 1] = Index(n - 1);
+            replace_run(b, s, s + 1);
+        }
+        else {
+            unlink_run(b, s);
+        }
+        skip[s] = 0;
+        return s;
+    }
+
+    static auto& links(Block& b, std::size_t i) noexcept { return b.slots[i].links; }
+
+    static void link_run(Block& b, std::size_t i) noexcept
+    {
+        links(b, i) = {none, b.free_head};
+        if (b.free_head != none) links(b, b.free_head).prev = Index(i);
+        b.free_head = Index(i);
+    }
+
+    static void unlink_run(Block& b, std::size_t i) noexcept
+    {
+        auto [prev, next] = links(b, i);
+        if (prev != none) links(b, prev).next = next;
+        else b.free_head = next;
+        if (next != none) links(b, next).prev = prev;
+    }
+
+    // Серия, начинавшаяся в from, теперь начинается в to
+    static void replace_run(Block& b, std::size_t from, std::size_t to) noexcept
+    {
+        auto [prev, next] = links(b, from);
+        links(b, to) = {prev, next};
+        if (prev != none) links(b, prev).next = Index(to);
+        else b.free_head = Index(to);
+        if (next != none) links(b, next).prev = Index(to);
+    }
+
+    std::vector<std::unique_ptr<Block>> blocks;
+    std::vector<Block*> with_free;      // Блоки с сериями удаленных
+    std::size_t fill{0};                // Блоки до fill заполнены до cap,
+                                        // после fill - не использовались
+    std::size_t count{0};
+};
+
+//------------------------------------------------------------------------------
+
+} // namespace em
+
+//------------------------------------------------------------------------------
+
+#endif // HIVE_HPP
+
+//------------------------------------------------------------------------------
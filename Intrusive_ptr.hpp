@@ -0,0 +1,381 @@
+//------------------------------------------------------------------------------
+
+// Интрузивный счетчик ссылок: альтернатива std::shared_ptr
+// и std::enable_shared_from_this из раздела 4.2
+
+// make_intrusive<T>() выделяет один блок: заголовок со счетчиками и сразу
+// за ним объект. Указатель Intrusive_ptr занимает одно слово, а
+// ref_from_this() находит счетчики по фиксированному смещению от this,
+// поэтому объекту не нужен слабый указатель на себя. make_intrusive
+// отмечает подобъект Ref_counted созданного объекта, в том числе
+// производного: make_intrusive<Derived>() при Derived : Base и
+// Base : Ref_counted<Base>. Для объекта, созданного иначе (на стеке,
+// членом, через new), и для объекта, уже разрушаемого (внутри ~T()),
+// ref_from_this() бросает std::bad_weak_ptr, как shared_from_this(), а
+// weak_from_this() возвращает пустой или истекший указатель. Счетчики
+// атомарные (Atomic_refcount) или обычные (Local_refcount, объект не
+// разделяется между потоками); выбор делается для каждого типа в
+// Ref_counted<T, ...>.
+// Как и у std::shared_ptr, объект разрушается, когда уходит последняя
+// сильная ссылка, а память освобождается после ухода последней слабой
+
+// Ограничения: преобразований Intrusive_ptr<Derived> в Intrusive_ptr<Base>
+// нет, выравнивание T не больше alignof(std::max_align_t). Производный
+// объект отмечается, только если подобъект Base лежит в его начале и у
+// Base виртуальный деструктор: последняя ссылка из ref_from_this()
+// разрушает объект через Base
+
+//------------------------------------------------------------------------------
+
+#ifndef INTRUSIVE_PTR_HPP
+#define INTRUSIVE_PTR_HPP
+
+//------------------------------------------------------------------------------
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+//------------------------------------------------------------------------------
+
+namespace em {
+
+//------------------------------------------------------------------------------
+// Политики счетчика
+
+struct Atomic_refcount {
+    using Count = std::atomic<std::uint32_t>;
+
+    // Возвращает прежнее значение
+    static std::uint32_t inc(Count& c) noexcept
+    { return c.fetch_add(1, std::memory_order_relaxed); }
+
+    // true, если счетчик обнулился
+    static bool dec(Count& c) noexcept
+    { return c.fetch_sub(1, std::memory_order_acq_rel) == 1; }
+
+    static bool inc_if_nonzero(Count& c) noexcept
+    {
+        auto n = c.load(std::memory_order_relaxed);
+        while (n && !c.compare_exchange_weak(n, n + 1,
+                                             std::memory_order_acquire,
+                                             std::memory_order_relaxed))
+            ;
+        return n != 0;
+    }
+
+    static std::uint32_t get(const Count& c) noexcept
+    { return c.load(std::memory_order_acquire); }
+};
+
+struct Local_refcount {
+    using Count = std::uint32_t;
+
+    static std::uint32_t inc(Count& c) noexcept { return c++; }
+    static bool dec(Count& c) noexcept { return --c == 0; }
+    static bool inc_if_nonzero(Count& c) noexcept { return c ? (++c, true) : false; }
+    static std::uint32_t get(const Count& c) noexcept { return c; }
+};
+
+//------------------------------------------------------------------------------
+
+template<class T> class Intrusive_ptr;
+template<class T> class Intrusive_weak_ptr;
+
+// Доступ make_intrusive к закрытым конструкторам:
+// в классе объявляется friend em::Intrusive_access;
+struct Intrusive_access {
+    template<class T, class... Ts>
+    static T* construct(void* where, Ts&&... params)
+    { return ::new (where) T(std::forward<Ts>(params)...); }
+
+    // Объект создан make_intrusive: перед ним заголовок счетчиков
+    template<class R>
+    static void mark_managed(R& obj) noexcept { obj.managed = true; }
+};
+
+//------------------------------------------------------------------------------
+// База для типов со встроенным счетчиком ссылок
+
+template<class T, class Policy = Atomic_refcount>
+class Ref_counted {
+public:
+    using Ref_policy = Policy;
+    using Ref_type = T;                 // Тип, для которого ведется счет
+
+    // Аналог shared_from_this(); для объекта, созданного не
+    // make_intrusive, - std::bad_weak_ptr
+    Intrusive_ptr<T> ref_from_this();
+    Intrusive_ptr<const T> ref_from_this() const;
+
+    // Пустой указатель для объекта, созданного не make_intrusive
+    Intrusive_weak_ptr<T> weak_from_this();
+protected:
+    Ref_counted() = default;
+    Ref_counted(const Ref_counted&) noexcept {}     // Копия - новый объект
+    Ref_counted& operator=(const Ref_counted&) noexcept { return *this; }
+    ~Ref_counted() = default;
+private:
+    friend struct Intrusive_access;
+
+    bool managed{false};
+};
+
+//------------------------------------------------------------------------------
+
+namespace intrusive_detail {
+
+template<class T>
+using Policy_of = typename std::remove_const_t<T>::Ref_policy;
+
+template<class Policy>
+struct Header {
+    typename Policy::Count strong{1};
+    typename Policy::Count weak{1};         // +1 от всех сильных вместе
+};
+
+constexpr std::size_t header_size = alignof(std::max_align_t);
+
+template<class T>
+Header<Policy_of<T>>* header_of(T* p) noexcept
+{
+    static_assert(sizeof(Header<Policy_of<T>>) <= header_size);
+    static_assert(alignof(std::remove_const_t<T>) <= header_size,
+                  "Выравнивание T больше поддерживаемого");
+    auto* bytes = reinterpret_cast<char*>(
+                const_cast<std::remove_const_t<T>*>(p));
+    return reinterpret_cast<Header<Policy_of<T>>*>(bytes - header_size);
+}
+
+// Отметка подобъекта Ref_counted<R> объекта obj, созданного
+// make_intrusive; R - T или его база (см. ограничения)
+template<class T>
+void mark_managed(T* obj) noexcept
+{
+    if constexpr (requires { typename T::Ref_type; }) {
+        using R = typename T::Ref_type;
+        using Base = Ref_counted<R, Policy_of<T>>;
+        if constexpr (std::is_base_of_v<Base, T>
+                      && (std::is_same_v<R, T> || std::has_virtual_destructor_v<R>)) {
+            R* r = obj;
+            if (static_cast<void*>(r) == static_cast<void*>(obj))
+                Intrusive_access::mark_managed<Base>(*obj);
+        }
+    }
+}
+
+template<class T>
+void release_weak(T* p) noexcept
+{
+    auto* h = header_of(p);
+    if (Policy_of<T>::dec(h->weak)) {
+        h->~Header();
+        ::operator delete(static_cast<void*>(h));
+    }
+}
+
+template<class T>
+void release_strong(T* p) noexcept
+{
+    if (Policy_of<T>::dec(header_of(p)->strong)) {
+        p->~T();
+        release_weak(p);
+    }
+}
+
+} // namespace intrusive_detail
+
+//------------------------------------------------------------------------------
+
+template<class T>
+class Intrusive_ptr {
+public:
+    using element_type = T;
+
+    Intrusive_ptr() noexcept = default;
+    Intrusive_ptr(std::nullptr_t) noexcept {}
+
+    Intrusive_ptr(const Intrusive_ptr& rhs) noexcept
+        : p{rhs.p} { if (p) Policy::inc(header()->strong); }
+    Intrusive_ptr(Intrusive_ptr&& rhs) noexcept
+        : p{std::exchange(rhs.p, nullptr)} {}
+
+    // Intrusive_ptr<const T> из Intrusive_ptr<T>
+    template<class U, class = std::enable_if_t<std::is_same_v<const U, T>
+                                               && !std::is_same_v<U, T>>>
+    Intrusive_ptr(Intrusive_ptr<U> rhs) noexcept
+        : p{rhs.release()} {}
+
+    Intrusive_ptr& operator=(Intrusive_ptr rhs) noexcept
+    {
+        swap(rhs);
+        return *this;
+    }
+
+    ~Intrusive_ptr() { if (p) intrusive_detail::release_strong(p); }
+
+    void swap(Intrusive_ptr& rhs) noexcept { std::swap(p, rhs.p); }
+    void reset() noexcept { Intrusive_ptr{}.swap(*this); }
+
+    T* get() const noexcept { return p; }
+    T& operator*() const noexcept { return *p; }
+    T* operator->() const noexcept { return p; }
+    explicit operator bool() const noexcept { return p != nullptr; }
+
+    std::uint32_t use_count() const noexcept
+    { return p ? Policy::get(header()->strong) : 0; }
+
+    // Отказ от владения без уменьшения счетчика
+    T* release() noexcept { return std::exchange(p, nullptr); }
+
+    // Захват уже учтенной ссылки
+    static Intrusive_ptr adopt(T* ptr) noexcept
+    {
+        Intrusive_ptr r;
+        r.p = ptr;
+        return r;
+    }
+
+    friend bool operator==(const Intrusive_ptr& a, const Intrusive_ptr& b)
+    { return a.p == b.p; }
+    friend bool operator!=(const Intrusive_ptr& a, const Intrusive_ptr& b)
+    { return a.p != b.p; }
+private:
+    using Policy = intrusive_detail::Policy_of<T>;
+
+    auto* header() const noexcept { return intrusive_detail::header_of(p); }
+
+    T* p{nullptr};
+};
+
+//------------------------------------------------------------------------------
+
+template<class T>
+class Intrusive_weak_ptr {
+public:
+    Intrusive_weak_ptr() noexcept = default;
+
+    Intrusive_weak_ptr(const Intrusive_ptr<T>& sp) noexcept
+        : p{sp.get()} { if (p) Policy::inc(header()->weak); }
+
+    Intrusive_weak_ptr(const Intrusive_weak_ptr& rhs) noexcept
+        : p{rhs.p} { if (p) Policy::inc(header()->weak); }
+    Intrusive_weak_ptr(Intrusive_weak_ptr&& rhs) noexcept
+        : p{std::exchange(rhs.p, nullptr)} {}
+
+    // Захват уже учтенной слабой ссылки
+    static Intrusive_weak_ptr adopt(T* ptr) noexcept
+    {
+        Intrusive_weak_ptr r;
+        r.p = ptr;
+        return r;
+    }
+
+    Intrusive_weak_ptr& operator=(Intrusive_weak_ptr rhs) noexcept
+    {
+        std::swap(p, rhs.p);
+        return *this;
+    }
+
+    ~Intrusive_weak_ptr() { if (p) intrusive_detail::release_weak(p); }
+
+    bool expired() const noexcept
+    { return !p || Policy::get(header()->strong) == 0; }
+
+    // Пустой указатель, если объект уже разрушен
+    Intrusive_ptr<T> lock() const noexcept
+    {
+        if (p && Policy::inc_if_nonzero(header()->strong))
+            return Intrusive_ptr<T>::adopt(p);
+        return nullptr;
+    }
+private:
+    using Policy = intrusive_detail::Policy_of<T>;
+
+    auto* header() const noexcept { return intrusive_detail::header_of(p); }
+
+    T* p{nullptr};
+};
+
+//------------------------------------------------------------------------------
+// Создание объекта с заголовком счетчиков в одном блоке памяти
+
+template<class T, class... Ts>
+Intrusive_ptr<T> make_intrusive(Ts&&... params)
+{
+    using Header =
+        intrusive_detail::Header<intrusive_detail::Policy_of<T>>;
+    constexpr auto offset = intrusive_detail::header_size;
+
+    void* mem = ::operator new(offset + sizeof(T));
+    auto* h = ::new (mem) Header{};
+    try {
+        auto* obj = Intrusive_access::construct<T>(
+                    static_cast<char*>(mem) + offset,
+                    std::forward<Ts>(params)...);
+        intrusive_detail::mark_managed(obj);
+        return Intrusive_ptr<T>::adopt(obj);
+    }
+    catch (...) {
+        h->~Header();
+        ::operator delete(mem);
+        throw;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+// Сильный счетчик 0 - объект уже разрушается (вызов из ~T()): счетчик
+// возвращается к нулю, и ссылка не воскрешает объект. Иначе вызывающий
+// держит объект живым, и одного увеличения достаточно
+
+template<class T, class Policy>
+Intrusive_ptr<T> Ref_counted<T, Policy>::ref_from_this()
+{
+    auto* self = static_cast<T*>(this);
+    if (!managed) throw std::bad_weak_ptr{};
+    auto& strong = intrusive_detail::header_of(self)->strong;
+    if (Policy::inc(strong) == 0) {
+        Policy::dec(strong);
+        throw std::bad_weak_ptr{};
+    }
+    return Intrusive_ptr<T>::adopt(self);
+}
+
+template<class T, class Policy>
+Intrusive_ptr<const T> Ref_counted<T, Policy>::ref_from_this() const
+{
+    auto* self = static_cast<const T*>(this);
+    if (!managed) throw std::bad_weak_ptr{};
+    auto& strong = intrusive_detail::header_of(self)->strong;
+    if (Policy::inc(strong) == 0) {
+        Policy::dec(strong);
+        throw std::bad_weak_ptr{};
+    }
+    return Intrusive_ptr<const T>::adopt(self);
+}
+
+// Слабая ссылка учитывается напрямую, без сильной: внутри ~T() указатель
+// просто истекший
+template<class T, class Policy>
+Intrusive_weak_ptr<T> Ref_counted<T, Policy>::weak_from_this()
+{
+    if (!managed) return {};
+    auto* self = static_cast<T*>(this);
+    Policy::inc(intrusive_detail::header_of(self)->weak);
+    return Intrusive_weak_ptr<T>::adopt(self);
+}
+
+//------------------------------------------------------------------------------
+
+} // namespace em
+
+//------------------------------------------------------------------------------
+
+#endif // INTRUSIVE_PTR_HPP
+
+//------------------------------------------------------------------------------
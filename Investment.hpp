@@ -0,0 +1,113 @@
+//------------------------------------------------------------------------------
+
+// Иерархия Investment и make_investment из раздела 4.1 поверх Slab_pool
+
+// Investment наследует Slab_allocated, поэтому new Stock/Bond/Real_estate
+// берет ячейку из пула, а delete в удалителе del_invmt возвращает ее туда.
+// Удалитель остается лямбда-выражением без состояния, и
+// std::unique_ptr<Investment, decltype(del_invmt)> имеет размер указателя
+
+//------------------------------------------------------------------------------
+
+#ifndef INVESTMENT_HPP
+#define INVESTMENT_HPP
+
+//------------------------------------------------------------------------------
+
+#include <memory>
+#include <string>
+#include <utility>
+#include "Async_log.hpp"
+#include "Slab_pool.hpp"
+
+//------------------------------------------------------------------------------
+
+namespace em {
+
+//------------------------------------------------------------------------------
+
+enum class Investment_kind { stock, bond, real_estate };
+
+class Investment : public Slab_allocated {
+public:
+    Investment(std::string n, double v)
+        : name{std::move(n)}, value{v} {}
+    virtual ~Investment() = default;    // Важная часть дизайна
+
+    virtual Investment_kind kind() const noexcept = 0;
+
+    const std::string& title() const noexcept { return name; }
+    double amount() const noexcept { return value; }
+private:
+    std::string name;
+    double value;
+};
+
+class Stock : public Investment {
+public:
+    using Investment::Investment;
+    Investment_kind kind() const noexcept override
+    { return Investment_kind::stock; }
+private:
+    int lots{0};
+};
+
+class Bond : public Investment {
+public:
+    using Investment::Investment;
+    Investment_kind kind() const noexcept override
+    { return Investment_kind::bond; }
+private:
+    double coupon{0};
+    long maturity{0};
+};
+
+class Real_estate : public Investment {
+public:
+    using Investment::Investment;
+    Investment_kind kind() const noexcept override
+    { return Investment_kind::real_estate; }
+private:
+    double area{0};
+    double lat{0}, lon{0};
+};
+
+//------------------------------------------------------------------------------
+
+inline constexpr auto del_invmt = [] (Investment* p_investment)
+{                                   // Пользовательский удалитель
+    make_log_entry(p_investment);   // без состояния
+    delete p_investment;            // Ячейка возвращается в Slab_pool
+};
+
+using Investment_ptr = std::unique_ptr<Investment, decltype(del_invmt)>;
+
+static_assert(sizeof(Investment_ptr) == sizeof(Investment*));
+
+template<class... Ts>
+Investment_ptr make_investment(Investment_kind kind, Ts&&... params)
+{
+    Investment_ptr p_inv(nullptr, del_invmt);
+    switch (kind) {
+    case Investment_kind::stock:
+        p_inv.reset(new Stock(std::forward<Ts>(params)...));
+        break;
+    case Investment_kind::bond:
+        p_inv.reset(new Bond(std::forward<Ts>(params)...));
+        break;
+    case Investment_kind::real_estate:
+        p_inv.reset(new Real_estate(std::forward<Ts>(params)...));
+        break;
+    }
+    return p_inv;
+}
+
+//------------------------------------------------------------------------------
+
+} // namespace em
+
+//------------------------------------------------------------------------------
+
+#endif // INVESTMENT_HPP
+
+//------------------------------------------------------------------------------
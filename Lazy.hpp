@@ -0,0 +1,255 @@
+//------------------------------------------------------------------------------
+
+// Lazy<T>: однократно вычисляемое и кэшируемое значение,
+// замена ручных кэшей Widget::magic_value из раздела 3.10
+
+// Значение вычисляется один раз, даже если его одновременно запрашивают
+// много потоков: первый вычисляет под мьютексом, остальные ждут его.
+// Затем оно публикуется через атомарный указатель, и дальше чтение -
+// без блокировок и без общего счетчика ссылок. T может быть любым типом
+// (не только int), так как атомарно публикуется указатель, а не само
+// значение. Значение читается внутри read(compute, visit) или копируется
+// get(compute); ссылки на него за пределы visit не выходят.
+// invalidate() снимает публикацию, а старое значение освобождается,
+// когда его не может читать ни один поток: читатель на время visit
+// отмечает в своей ячейке эпоху (epoch-based reclamation), и снятые
+// значения удаляются, как только все отмеченные эпохи новее снятия.
+// Читатель пишет только в свою кэш-линию; вызывающему не нужно ничего
+// освобождать вручную
+
+//------------------------------------------------------------------------------
+
+#ifndef LAZY_HPP
+#define LAZY_HPP
+
+//------------------------------------------------------------------------------
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "Sharded_counter.hpp"
+
+//------------------------------------------------------------------------------
+
+namespace em {
+
+//------------------------------------------------------------------------------
+// Общая для всех Lazy эпоха и ячейки читающих потоков
+
+namespace lazy_detail {
+
+struct alignas(cache_line_size) Reader_slot {
+    std::atomic<std::uint64_t> epoch{0};    // 0 - поток вне чтения
+    std::atomic<bool> used{true};
+    Reader_slot* next{nullptr};
+};
+
+class Epoch_domain {
+public:
+    static Epoch_domain& instance()
+    {
+        static Epoch_domain domain;
+        return domain;
+    }
+
+    Epoch_domain(const Epoch_domain&) = delete;
+    Epoch_domain& operator=(const Epoch_domain&) = delete;
+
+    ~Epoch_domain()
+    {
+        for (auto& r : retired) r.destroy(r.p);
+        for (auto* s = slots.load(); s; ) delete std::exchange(s, s->next);
+    }
+
+    // Вход в чтение (вложенные входы только считаются)
+    void enter()
+    {
+        auto& t = local();
+        if (t.nesting++ == 0)
+            t.slot->epoch.store(epoch.load(std::memory_order_acquire),
+                                std::memory_order_seq_cst);
+    }
+
+    void leave() noexcept
+    {
+        auto& t = local();
+        if (--t.nesting == 0) t.slot->epoch.store(0, std::memory_order_release);
+    }
+
+    // p уже недостижим для новых читателей; destroy(p) вызывается, когда
+    // завершатся все чтения, начавшиеся до этого вызова
+    void retire(const void* p, void (*destroy)(const void*))
+    {
+        auto e = epoch.fetch_add(1, std::memory_order_seq_cst);
+        std::vector<Retired> ready;
+        {
+            std::lock_guard<std::mutex> g{retired_mutex};
+            retired.push_back({e, p, destroy});
+
+            auto oldest = std::numeric_limits<std::uint64_t>::max();
+            for (auto* s = slots.load(std::memory_order_acquire); s; s = s->next)
+                if (auto se = s->epoch.load(std::memory_order_seq_cst); se && se < oldest)
+                    oldest = se;
+
+            // Значение, снятое в эпоху e, видно только чтениям с эпохой <= e
+            for (std::size_t i = 0; i < retired.size(); ) {
+                if (retired[i].epoch < oldest) {
+                    ready.push_back(retired[i]);
+                    retired[i] = retired.back();
+                    retired.pop_back();
+                }
+                else
+                    ++i;
+            }
+        }
+        for (auto& r : ready) r.destroy(r.p);     // Вне блокировки
+    }
+private:
+    struct Retired {
+        std::uint64_t epoch;
+        const void* p;
+        void (*destroy)(const void*);
+    };
+
+    struct Thread_state {
+        Reader_slot* slot{nullptr};
+        unsigned nesting{0};
+
+        ~Thread_state()
+        {
+            if (slot) slot->used.store(false, std::memory_order_release);
+        }
+    };
+
+    Epoch_domain() = default;
+
+    // Ячейка текущего потока: свободная из списка или новая
+    Thread_state& local()
+    {
+        thread_local Thread_state t;
+        if (!t.slot) {
+            for (auto* s = slots.load(std::memory_order_acquire); s && !t.slot; s = s->next) {
+                bool expected = false;
+                if (s->used.compare_exchange_strong(expected, true, std::memory_order_acquire))
+                    t.slot = s;
+            }
+            if (!t.slot) {
+                auto* s = new Reader_slot;
+                s->next = slots.load(std::memory_order_relaxed);
+                while (!slots.compare_exchange_weak(s->next, s, std::memory_order_release,
+                                                    std::memory_order_relaxed)) {}
+                t.slot = s;
+            }
+        }
+        return t;
+    }
+
+    std::atomic<std::uint64_t> epoch{1};
+    std::atomic<Reader_slot*> slots{nullptr};   // Только растет
+    std::mutex retired_mutex;
+    std::vector<Retired> retired;
+};
+
+class Read_guard {
+public:
+    Read_guard() : domain{Epoch_domain::instance()} { domain.enter(); }
+    ~Read_guard() { domain.leave(); }
+
+    Read_guard(const Read_guard&) = delete;
+    Read_guard& operator=(const Read_guard&) = delete;
+private:
+    Epoch_domain& domain;
+};
+
+} // namespace lazy_detail
+
+//------------------------------------------------------------------------------
+
+template<class T>
+class Lazy {
+public:
+    using Value_type = T;
+
+    Lazy() = default;
+
+    // Копия кэша пуста: значение будет вычислено заново при первом чтении,
+    // что позволяет хранить Lazy в копируемых классах
+    Lazy(const Lazy&) {}
+    Lazy& operator=(const Lazy&) { invalidate(); return *this; }
+
+    // Одновременных чтений уже нет
+    ~Lazy() { delete current.load(std::memory_order_relaxed); }
+
+    // visit(const T&) над значением; compute() вызывается, только если
+    // оно еще не опубликовано. Исключение из compute() пропускается
+    // наружу, кэш остается пустым. Результат visit возвращается по
+    // значению: ссылка на T после выхода из read() недействительна
+    template<class F, class V>
+    auto read(F&& compute, V&& visit) const
+    {
+        lazy_detail::Read_guard g;
+        auto* p = current.load(std::memory_order_seq_cst);
+        if (!p) p = publish_slow(std::forward<F>(compute));
+        return std::invoke(std::forward<V>(visit), *p);
+    }
+
+    // Копия значения
+    template<class F>
+    T get(F&& compute) const
+    { return read(std::forward<F>(compute), [] (const T& v) { return v; }); }
+
+    bool has_value() const noexcept
+    { return current.load(std::memory_order_acquire) != nullptr; }
+
+    // Явная публикация готового значения
+    template<class... Ts>
+    void emplace(Ts&&... params)
+    {
+        auto* fresh = new const T(std::forward<Ts>(params)...);
+        std::lock_guard<std::mutex> g{m};
+        retire(current.exchange(fresh, std::memory_order_seq_cst));
+    }
+
+    // Следующее чтение вычислит значение заново
+    void invalidate()
+    {
+        std::lock_guard<std::mutex> g{m};
+        retire(current.exchange(nullptr, std::memory_order_seq_cst));
+    }
+private:
+    // Вызывается внутри чтения: опубликованный указатель защищен им
+    template<class F>
+    const T* publish_slow(F&& compute) const
+    {
+        std::lock_guard<std::mutex> g{m};
+        if (auto* p = current.load(std::memory_order_seq_cst))
+            return p;                       // Опубликовал другой поток
+        auto* fresh = new const T(std::forward<F>(compute)());
+        current.store(fresh, std::memory_order_seq_cst);
+        return fresh;
+    }
+
+    static void retire(const T* p)
+    {
+        if (p)
+            lazy_detail::Epoch_domain::instance().retire(
+                        p, [] (const void* v) { delete static_cast<const T*>(v); });
+    }
+
+    mutable std::mutex m;                   // Только вычисление и запись
+    mutable std::atomic<const T*> current{nullptr};
+};
+
+//------------------------------------------------------------------------------
+
+} // namespace em
+
+//------------------------------------------------------------------------------
+
+#endif // LAZY_HPP
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,277 @@
+//------------------------------------------------------------------------------
+
+// Словарь имен для name_from_idx из разделов 5.4 и 5.5: файл только для
+// чтения, отображаемый в память, и поиск имени по индексу без выделения
+// памяти вместо std::string, возвращаемого по значению
+
+// Формат файла (порядок байтов - родной для машины, проверяется при
+// открытии): заголовок Name_dictionary_header, таблица count + 1
+// смещений uint64 и блок байтов имен; имя i - байты [offsets[i],
+// offsets[i + 1] - 1) блока, за ним '\0'. Файл пишет
+// write_name_dictionary (через временный файл и rename, так что читатели
+// видят либо старый, либо новый словарь целиком). При открытии файл
+// отображается в память (mmap; без POSIX - читается одним блоком) и
+// проверяются только заголовок и размеры - O(1), без разбора имен;
+// страницы подгружаются по мере обращения. Поиск - два чтения из таблицы
+// смещений, результат - std::string_view на отображенные байты,
+// действительный до уничтожения словаря. operator[] не проверяет ничего,
+// at() проверяет индекс и смещения этого имени
+
+//------------------------------------------------------------------------------
+
+#ifndef NAME_DICTIONARY_HPP
+#define NAME_DICTIONARY_HPP
+
+//------------------------------------------------------------------------------
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define EM_NAME_DICTIONARY_MMAP
+#endif
+
+//------------------------------------------------------------------------------
+
+namespace em {
+
+//------------------------------------------------------------------------------
+
+struct Name_dictionary_header {
+    static constexpr char file_magic[8] = {'E', 'M', 'N', 'A', 'M', 'E', 'S', '\0'};
+    static constexpr std::uint32_t native_order = 0x01020304;
+    static constexpr std::uint32_t current_version = 1;
+
+    char magic[8];
+    std::uint32_t byte_order;
+    std::uint32_t version;
+    std::uint64_t count;            // Число имен
+    std::uint64_t blob_bytes;       // Байтов имен вместе с '\0'
+};
+
+static_assert(sizeof(Name_dictionary_header) == 32);
+
+// Запись словаря из names (диапазон строк, проходится дважды);
+// индекс имени в словаре - его позиция в names
+template<class Range>
+void write_name_dictionary(const std::string& path, const Range& names)
+{
+    using Header = Name_dictionary_header;
+
+    Header h{};
+    std::memcpy(h.magic, Header::file_magic, sizeof h.magic);
+    h.byte_order = Header::native_order;
+    h.version = Header::current_version;
+    for (const auto& n : names) {
+        ++h.count;
+        h.blob_bytes += std::string_view{n}.size() + 1;
+    }
+
+    auto tmp = path + ".tmp";
+    {
+        std::ofstream out{tmp, std::ios::binary | std::ios::trunc};
+        if (!out) throw std::runtime_error{"Name_dictionary: не удалось создать " + tmp};
+
+        out.write(reinterpret_cast<const char*>(&h), sizeof h);
+        std::uint64_t off = 0;
+        out.write(reinterpret_cast<const char*>(&off), sizeof off);
+        for (const auto& n : names) {
+            off += std::string_view{n}.size() + 1;
+            out.write(reinterpret_cast<const char*>(&off), sizeof off);
+        }
+        for (const auto& n : names) {
+            std::string_view s{n};
+            out.write(s.data(), std::streamsize(s.size()));
+            out.put('\0');
+        }
+        if (!out.flush()) throw std::runtime_error{"Name_dictionary: ошибка записи " + tmp};
+    }
+    if (std::rename(tmp.c_str(), path.c_str()) != 0)
+        throw std::system_error{errno, std::generic_category(),
+                                "Name_dictionary: rename " + tmp};
+}
+
+//------------------------------------------------------------------------------
+
+class Name_dictionary {
+public:
+    Name_dictionary() noexcept = default;
+
+    explicit Name_dictionary(const std::string& path)
+    {
+        map(path);
+        try {
+            validate(path);
+        }
+        catch (...) {
+            unmap();
+            throw;
+        }
+    }
+
+    Name_dictionary(Name_dictionary&& rhs) noexcept { swap(rhs); }
+
+    Name_dictionary& operator=(Name_dictionary&& rhs) noexcept
+    {
+        Name_dictionary{std::move(rhs)}.swap(*this);
+        return *this;
+    }
+
+    Name_dictionary(const Name_dictionary&) = delete;
+    Name_dictionary& operator=(const Name_dictionary&) = delete;
+
+    ~Name_dictionary() { unmap(); }
+
+    std::size_t size() const noexcept { return count; }
+    bool empty() const noexcept { return count == 0; }
+
+    // Имя idx; idx < size()
+    std::string_view operator[](std::size_t idx) const noexcept
+    {
+        auto b = offsets[idx];
+        return {blob + b, std::size_t(offsets[idx + 1] - b - 1)};
+    }
+
+    std::string_view at(std::size_t idx) const
+    {
+        if (idx >= count) throw std::out_of_range{"Name_dictionary: индекс вне словаря"};
+        auto b = offsets[idx];
+        auto e = offsets[idx + 1];
+        if (b >= e || e > blob_bytes || blob[e - 1] != '\0')
+            throw std::runtime_error{"Name_dictionary: поврежденная таблица смещений"};
+        return {blob + b, std::size_t(e - b - 1)};
+    }
+
+    // Отображенный файл целиком
+    std::size_t file_bytes() const noexcept { return bytes; }
+private:
+    using Header = Name_dictionary_header;
+
+    void swap(Name_dictionary& rhs) noexcept
+    {
+        std::swap(base, rhs.base);
+        std::swap(bytes, rhs.bytes);
+#ifndef EM_NAME_DICTIONARY_MMAP
+        std::swap(owned, rhs.owned);
+#endif
+        std::swap(offsets, rhs.offsets);
+        std::swap(blob, rhs.blob);
+        std::swap(count, rhs.count);
+        std::swap(blob_bytes, rhs.blob_bytes);
+    }
+
+#ifdef EM_NAME_DICTIONARY_MMAP
+    void map(const std::string& path)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            throw std::system_error{errno, std::generic_category(), "Name_dictionary: open " + path};
+
+        struct stat st{};
+        if (::fstat(fd, &st) != 0) {
+            int err = errno;
+            ::close(fd);
+            throw std::system_error{err, std::generic_category(), "Name_dictionary: fstat " + path};
+        }
+        bytes = std::size_t(st.st_size);
+        if (bytes < sizeof(Header)) {
+            ::close(fd);
+            throw std::runtime_error{"Name_dictionary: " + path + " - не словарь имен"};
+        }
+
+        void* p = ::mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        int err = errno;
+        ::close(fd);                    // Отображение остается и без дескриптора
+        if (p == MAP_FAILED)
+            throw std::system_error{err, std::generic_category(), "Name_dictionary: mmap " + path};
+        base = static_cast<const char*>(p);
+    }
+
+    void unmap() noexcept
+    {
+        if (base) ::munmap(const_cast<char*>(base), bytes);
+        base = nullptr;
+    }
+#else
+    void map(const std::string& path)
+    {
+        std::ifstream in{path, std::ios::binary | std::ios::ate};
+        if (!in) throw std::runtime_error{"Name_dictionary: не удалось открыть " + path};
+        bytes = std::size_t(in.tellg());
+        if (bytes < sizeof(Header))
+            throw std::runtime_error{"Name_dictionary: " + path + " - не словарь имен"};
+
+        // Память под uint64 выровнена для таблицы смещений
+        owned.reset(new std::uint64_t[(bytes + 7) / 8]);
+        in.seekg(0);
+        if (!in.read(reinterpret_cast<char*>(owned.get()), std::streamsize(bytes)))
+            throw std::runtime_error{"Name_dictionary: ошибка чтения " + path};
+        base = reinterpret_cast<const char*>(owned.get());
+    }
+
+    void unmap() noexcept
+    {
+        owned.reset();
+        base = nullptr;
+    }
+#endif
+
+    void validate(const std::string& path)
+    {
+        Header h;
+        std::memcpy(&h, base, sizeof h);
+        if (std::memcmp(h.magic, Header::file_magic, sizeof h.magic) != 0)
+            throw std::runtime_error{"Name_dictionary: " + path + " - не словарь имен"};
+        if (h.byte_order != Header::native_order)
+            throw std::runtime_error{"Name_dictionary: " + path + " - другой порядок байтов"};
+        if (h.version != Header::current_version)
+            throw std::runtime_error{"Name_dictionary: " + path + " - неизвестная версия формата"};
+
+        // Размеры без переполнения: таблица и блок целиком внутри файла
+        auto rest = bytes - sizeof h;
+        if (h.count >= rest / sizeof(std::uint64_t)
+            || h.blob_bytes != rest - (h.count + 1) * sizeof(std::uint64_t))
+            throw std::runtime_error{"Name_dictionary: " + path + " - неверный размер файла"};
+
+        offsets = reinterpret_cast<const std::uint64_t*>(base + sizeof h);
+        blob = reinterpret_cast<const char*>(offsets + h.count + 1);
+        count = std::size_t(h.count);
+        blob_bytes = std::size_t(h.blob_bytes);
+        if (offsets[0] != 0 || offsets[count] != blob_bytes)
+            throw std::runtime_error{"Name_dictionary: " + path + " - поврежденная таблица смещений"};
+    }
+
+    const char* base{nullptr};
+    std::size_t bytes{0};
+#ifndef EM_NAME_DICTIONARY_MMAP
+    std::unique_ptr<std::uint64_t[]> owned;     // Прочитанный файл
+#endif
+    const std::uint64_t* offsets{nullptr};
+    const char* blob{nullptr};
+    std::size_t count{0};
+    std::size_t blob_bytes{0};
+};
+
+//------------------------------------------------------------------------------
+
+} // namespace em
+
+//------------------------------------------------------------------------------
+
+#endif // NAME_DICTIONARY_HPP
+
+//------------------------------------------------------------------------------
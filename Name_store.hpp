@@ -0,0 +1,191 @@
+//------------------------------------------------------------------------------
+
+// Хранилище имен для Widget::add_name из раздела 8.1: строки интернируются
+// в общую арену вместо отдельного блока кучи на каждое имя каждого виджета
+
+// Байты имен дописываются в блоки арены по block_bytes (длинные имена -
+// в собственный блок); блоки не перемещаются и не освобождаются до
+// уничтожения хранилища, поэтому выданные Interned_name действительны все
+// это время. Одинаковые строки находятся по хеш-индексу с открытой
+// адресацией и хранятся один раз: миллионы виджетов с именами из
+// небольшого словаря делят одни и те же байты. Interned_name - указатель
+// и длина (как string_view); имена одного хранилища равны тогда и только
+// тогда, когда равны указатели. Хранилище не потокобезопасно
+
+//------------------------------------------------------------------------------
+
+#ifndef NAME_STORE_HPP
+#define NAME_STORE_HPP
+
+//------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+namespace em {
+
+//------------------------------------------------------------------------------
+
+class Interned_name {
+public:
+    constexpr Interned_name() noexcept = default;
+
+    std::string_view view() const noexcept { return {p, n}; }
+    operator std::string_view() const noexcept { return view(); }
+
+    const char* data() const noexcept { return p; }
+    const char* c_str() const noexcept { return p; }  // Завершается '\0'
+    std::size_t size() const noexcept { return n; }
+    bool empty() const noexcept { return n == 0; }
+
+    std::string str() const { return std::string{p, n}; }
+
+    // Для имен одного хранилища
+    friend bool operator==(Interned_name a, Interned_name b) noexcept
+    { return a.p == b.p; }
+private:
+    friend class Name_store;
+
+    constexpr Interned_name(const char* p, std::uint32_t n) noexcept : p{p}, n{n} {}
+
+    const char* p{""};
+    std::uint32_t n{0};
+};
+
+//------------------------------------------------------------------------------
+
+class Name_store {
+public:
+    static constexpr std::size_t default_block_bytes = 64 * 1024;
+
+    explicit Name_store(std::size_t block_bytes = default_block_bytes)
+        : block_bytes{block_bytes} {}
+
+    Name_store(const Name_store&) = delete;
+    Name_store& operator=(const Name_store&) = delete;
+
+    // Имя s из хранилища; при первом появлении s копируется в арену
+    Interned_name intern(std::string_view s)
+    {
+        if (s.empty()) return {};
+        auto h = hash(s);
+        if (auto i = lookup(s, h)) return entries[*i].name;
+
+        if (4 * (entries.size() + 1) > 3 * slots.size()) grow();
+        auto name = append(s);
+        entries.push_back({name, h});
+        place(std::uint32_t(entries.size()));
+        return name;
+    }
+
+    // Имя s, если оно уже интернировано
+    std::optional<Interned_name> find(std::string_view s) const
+    {
+        if (s.empty()) return Interned_name{};
+        if (auto i = lookup(s, hash(s))) return entries[*i].name;
+        return std::nullopt;
+    }
+
+    // Различных непустых имен
+    std::size_t size() const noexcept { return entries.size(); }
+
+    // Байт имен в арене (с завершающими нулями) и всего выделено под арену
+    std::size_t bytes_used() const noexcept { return used; }
+    std::size_t bytes_reserved() const noexcept { return reserved; }
+private:
+    struct Entry {
+        Interned_name name;
+        std::size_t hash;
+    };
+
+    static std::size_t hash(std::string_view s) noexcept
+    { return std::hash<std::string_view>{}(s); }
+
+    // Индекс в entries
+    std::optional<std::size_t> lookup(std::string_view s, std::size_t h) const noexcept
+    {
+        if (slots.empty()) return std::nullopt;
+        auto mask = slots.size() - 1;
+        for (auto i = h & mask; slots[i]; i = (i + 1) & mask) {
+            const auto& e = entries[slots[i] - 1];
+            if (e.hash == h && e.name.view() == s) return slots[i] - 1;
+        }
+        return std::nullopt;
+    }
+
+    // slot - номер записи, начиная с 1 (0 - пустая ячейка)
+    void place(std::uint32_t slot) noexcept
+    {
+        auto mask = slots.size() - 1;
+        auto i = entries[slot - 1].hash & mask;
+        while (slots[i]) i = (i + 1) & mask;
+        slots[i] = slot;
+    }
+
+    void grow()
+    {
+        slots.assign(std::max<std::size_t>(16, 2 * slots.size()), 0);
+        for (std::size_t i = 0; i < entries.size(); ++i) place(std::uint32_t(i + 1));
+    }
+
+    Interned_name append(std::string_view s)
+    {
+        if (s.size() > UINT32_MAX) throw std::length_error{"Name_store: слишком длинное имя"};
+        auto need = s.size() + 1;
+        char* p;
+        if (need > block_bytes) {           // Остаток текущего блока не теряется
+            p = new_block(need);
+        }
+        else {
+            if (need > left) {
+                cur = new_block(block_bytes);
+                left = block_bytes;
+            }
+            p = cur;
+            cur += need;
+            left -= need;
+        }
+        std::memcpy(p, s.data(), s.size());
+        p[s.size()] = '\0';
+        used += need;
+        return {p, std::uint32_t(s.size())};
+    }
+
+    char* new_block(std::size_t size)
+    {
+        blocks.push_back(std::make_unique_for_overwrite<char[]>(size));
+        reserved += size;
+        return blocks.back().get();
+    }
+
+    std::size_t block_bytes;
+    std::vector<std::unique_ptr<char[]>> blocks;
+    char* cur{nullptr};
+    std::size_t left{0};
+    std::size_t used{0};
+    std::size_t reserved{0};
+
+    std::vector<Entry> entries;
+    std::vector<std::uint32_t> slots;   // Степень двойки, заполнение <= 3/4
+};
+
+//------------------------------------------------------------------------------
+
+} // namespace em
+
+//------------------------------------------------------------------------------
+
+#endif // NAME_STORE_HPP
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,352 @@
+//------------------------------------------------------------------------------
+
+// normalize из раздела 6.3 для векторов признаков float/double: L2,
+// min-max и z-score, ядра AVX2
+
+// Перегрузки различают категорию значения аргумента, который лямбда-
+// выражения раздела 6.3 передают через std::forward<decltype(x)>(x):
+//   normalize(std::move(v))  - rvalue: на месте, возвращается та же память;
+//   normalize(v, out)        - lvalue: результат в буфер вызывающего;
+//   normalize(v)             - запрещено, чтобы копия не делалась незаметно.
+// Все три вида - аффинное преобразование (x - a) * b: сначала проход
+// редукции (сумма квадратов, минимум и максимум, среднее и дисперсия),
+// затем один проход преобразования. Редукции для float накапливаются
+// в double, и преобразование float тоже идет в double: 1 / норма для
+// денормализованного входа не помещается во float. Для double, где 1 / d
+// переполняется или денормализуется, x - a сначала масштабируется точной
+// степенью двойки (сумма квадратов в double по-прежнему теряет значения
+// меньше 1e-154 и больше 1e154). Если норма, размах или отклонение равны
+// нулю, результат - нули. Выход и вход совпадают целиком или не пересекаются
+
+//------------------------------------------------------------------------------
+
+#ifndef NORMALIZE_HPP
+#define NORMALIZE_HPP
+
+//------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "Simd.hpp"
+
+//------------------------------------------------------------------------------
+
+namespace em {
+
+//------------------------------------------------------------------------------
+
+enum class Norm { l2, min_max, z_score };
+
+template<class T>
+concept Normalizable = std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+//------------------------------------------------------------------------------
+
+namespace normalize_detail {
+
+// Сумма (x - center)^2
+template<class T>
+double sum_squares_scalar(const T* p, std::size_t n, double center) noexcept
+{
+    double acc = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        auto d = double(p[i]) - center;
+        acc += d * d;
+    }
+    return acc;
+}
+
+template<class T>
+double sum_scalar(const T* p, std::size_t n) noexcept
+{
+    double acc = 0;
+    for (std::size_t i = 0; i < n; ++i) acc += p[i];
+    return acc;
+}
+
+template<class T>
+std::pair<T, T> min_max_scalar(const T* p, std::size_t n) noexcept
+{
+    auto lo = p[0];
+    auto hi = p[0];
+    for (std::size_t i = 1; i < n; ++i) {
+        lo = std::min(lo, p[i]);
+        hi = std::max(hi, p[i]);
+    }
+    return {lo, hi};
+}
+
+// Преобразование ((x - a) * s) * b в double; s - степень двойки
+struct Affine {
+    double a;
+    double s;
+    double b;
+};
+
+template<class T>
+void affine_scalar(const T* in, T* out, std::size_t n, const Affine& f) noexcept
+{
+    for (std::size_t i = 0; i < n; ++i)
+        out[i] = T((double(in[i]) - f.a) * f.s * f.b);
+}
+
+#ifdef EM_SIMD_X86
+
+// Восемь значений как два вектора double
+template<class T>
+EM_TARGET_AVX2 inline void load8(const T* p, __m256d& lo, __m256d& hi) noexcept
+{
+    if constexpr (std::is_same_v<T, float>) {
+        auto v = _mm256_loadu_ps(p);
+        lo = _mm256_cvtps_pd(_mm256_castps256_ps128(v));
+        hi = _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1));
+    }
+    else {
+        lo = _mm256_loadu_pd(p);
+        hi = _mm256_loadu_pd(p + 4);
+    }
+}
+
+// Обратное к load8
+template<class T>
+EM_TARGET_AVX2 inline void store8(T* p, __m256d lo, __m256d hi) noexcept
+{
+    if constexpr (std::is_same_v<T, float>)
+        _mm256_storeu_ps(p, _mm256_set_m128(_mm256_cvtpd_ps(hi), _mm256_cvtpd_ps(lo)));
+    else {
+        _mm256_storeu_pd(p, lo);
+        _mm256_storeu_pd(p + 4, hi);
+    }
+}
+
+EM_TARGET_AVX2 inline double horizontal_sum(__m256d v) noexcept
+{
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, v);
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+template<class T>
+EM_TARGET_AVX2 inline double sum_squares_avx2(const T* p, std::size_t n,
+                                              double center) noexcept
+{
+    const auto c = _mm256_set1_pd(center);
+    auto acc0 = _mm256_setzero_pd();
+    auto acc1 = _mm256_setzero_pd();
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256d lo, hi;
+        load8(p + i, lo, hi);
+        lo = _mm256_sub_pd(lo, c);
+        hi = _mm256_sub_pd(hi, c);
+        acc0 = _mm256_add_pd(acc0, _mm256_mul_pd(lo, lo));
+        acc1 = _mm256_add_pd(acc1, _mm256_mul_pd(hi, hi));
+    }
+    return horizontal_sum(_mm256_add_pd(acc0, acc1))
+         + sum_squares_scalar(p + i, n - i, center);
+}
+
+template<class T>
+EM_TARGET_AVX2 inline double sum_avx2(const T* p, std::size_t n) noexcept
+{
+    auto acc0 = _mm256_setzero_pd();
+    auto acc1 = _mm256_setzero_pd();
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256d lo, hi;
+        load8(p + i, lo, hi);
+        acc0 = _mm256_add_pd(acc0, lo);
+        acc1 = _mm256_add_pd(acc1, hi);
+    }
+    return horizontal_sum(_mm256_add_pd(acc0, acc1)) + sum_scalar(p + i, n - i);
+}
+
+template<class T>
+EM_TARGET_AVX2 inline std::pair<T, T> min_max_avx2(const T* p, std::size_t n) noexcept
+{
+    constexpr std::size_t lanes = 32 / sizeof(T);
+    if (n < lanes) return min_max_scalar(p, n);
+
+    std::size_t i = lanes;
+    T lo_lanes[lanes];
+    T hi_lanes[lanes];
+    if constexpr (std::is_same_v<T, float>) {
+        auto lo = _mm256_loadu_ps(p);
+        auto hi = lo;
+        for (; i + lanes <= n; i += lanes) {
+            auto v = _mm256_loadu_ps(p + i);
+            lo = _mm256_min_ps(lo, v);
+            hi = _mm256_max_ps(hi, v);
+        }
+        _mm256_storeu_ps(lo_lanes, lo);
+        _mm256_storeu_ps(hi_lanes, hi);
+    }
+    else {
+        auto lo = _mm256_loadu_pd(p);
+        auto hi = lo;
+        for (; i + lanes <= n; i += lanes) {
+            auto v = _mm256_loadu_pd(p + i);
+            lo = _mm256_min_pd(lo, v);
+            hi = _mm256_max_pd(hi, v);
+        }
+        _mm256_storeu_pd(lo_lanes, lo);
+        _mm256_storeu_pd(hi_lanes, hi);
+    }
+    auto [lo, hi] = min_max_scalar(p + i - lanes, n - i + lanes);
+    for (std::size_t k = 0; k < lanes; ++k) {
+        lo = std::min(lo, lo_lanes[k]);
+        hi = std::max(hi, hi_lanes[k]);
+    }
+    return {lo, hi};
+}
+
+template<class T>
+EM_TARGET_AVX2 inline void affine_avx2(const T* in, T* out, std::size_t n,
+                                       const Affine& f) noexcept
+{
+    const auto va = _mm256_set1_pd(f.a);
+    const auto vs = _mm256_set1_pd(f.s);
+    const auto vb = _mm256_set1_pd(f.b);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256d lo, hi;
+        load8(in + i, lo, hi);
+        lo = _mm256_mul_pd(_mm256_mul_pd(_mm256_sub_pd(lo, va), vs), vb);
+        hi = _mm256_mul_pd(_mm256_mul_pd(_mm256_sub_pd(hi, va), vs), vb);
+        store8(out + i, lo, hi);
+    }
+    affine_scalar(in + i, out + i, n - i, f);
+}
+
+#endif // EM_SIMD_X86
+
+inline bool use_avx2() noexcept
+{
+#ifdef EM_SIMD_X86
+    return simd_level() == Simd_level::avx2;
+#else
+    return false;
+#endif
+}
+
+template<class T>
+double sum_squares(const T* p, std::size_t n, double center) noexcept
+{
+#ifdef EM_SIMD_X86
+    if (use_avx2()) return sum_squares_avx2(p, n, center);
+#endif
+    return sum_squares_scalar(p, n, center);
+}
+
+template<class T>
+double sum(const T* p, std::size_t n) noexcept
+{
+#ifdef EM_SIMD_X86
+    if (use_avx2()) return sum_avx2(p, n);
+#endif
+    return sum_scalar(p, n);
+}
+
+template<class T>
+std::pair<T, T> min_max(const T* p, std::size_t n) noexcept
+{
+#ifdef EM_SIMD_X86
+    if (use_avx2()) return min_max_avx2(p, n);
+#endif
+    return min_max_scalar(p, n);
+}
+
+template<class T>
+void affine(const T* in, T* out, std::size_t n, const Affine& f) noexcept
+{
+#ifdef EM_SIMD_X86
+    if (use_avx2()) return affine_avx2(in, out, n, f);
+#endif
+    affine_scalar(in, out, n, f);
+}
+
+// Деление на d как умножение: s подбирается так, чтобы 1 / (d * s) было
+// нормальным числом. Для d из float это всегда s = 1
+inline Affine divide_by(double a, double d) noexcept
+{
+    if (!(d > 0)) return {a, 1, 0};
+    double s = 1;
+    if (!std::isnormal(1 / d)) s = d < 1 ? 0x1p600 : 0x1p-600;
+    return {a, s, 1 / (d * s)};
+}
+
+template<class T>
+Affine coefficients(const T* p, std::size_t n, Norm kind) noexcept
+{
+    switch (kind) {
+    case Norm::min_max: {
+        auto [lo, hi] = min_max(p, n);
+        return divide_by(lo, double(hi) - double(lo));
+    }
+    case Norm::z_score: {
+        auto mean = sum(p, n) / double(n);
+        return divide_by(mean, std::sqrt(sum_squares(p, n, mean) / double(n)));
+    }
+    default:
+        return divide_by(0, std::sqrt(sum_squares(p, n, 0.0)));
+    }
+}
+
+} // namespace normalize_detail
+
+//------------------------------------------------------------------------------
+
+// Нормализация in в out (того же размера). T выводится только из out:
+// in принимает все, что приводится к std::span<const T> - изменяемый
+// span, вектор, массив
+template<Normalizable T>
+void normalize(std::type_identity_t<std::span<const T>> in, std::span<T> out,
+               Norm kind = Norm::l2)
+{
+    if (in.size() != out.size())
+        throw std::invalid_argument{"normalize: размеры входа и выхода различны"};
+    if (in.empty()) return;
+    const auto f = normalize_detail::coefficients(in.data(), in.size(), kind);
+    normalize_detail::affine(in.data(), out.data(), in.size(), f);
+}
+
+// Нормализация на месте через изменяемое представление
+template<Normalizable T>
+void normalize(std::span<T> v, Norm kind = Norm::l2)
+{ normalize(std::span<const T>{v}, v, kind); }
+
+// rvalue: на месте, возвращается та же память
+template<Normalizable T>
+std::vector<T> normalize(std::vector<T>&& v, Norm kind = Norm::l2)
+{
+    normalize(std::span<T>{v}, kind);
+    return std::move(v);
+}
+
+// lvalue: буфер out переиспользуется (размер подгоняется под in)
+template<Normalizable T>
+void normalize(const std::vector<T>& in, std::vector<T>& out, Norm kind = Norm::l2)
+{
+    out.resize(in.size());
+    normalize(std::span<const T>{in}, std::span<T>{out}, kind);
+}
+
+// lvalue без буфера: нужен normalize(v, out) или normalize(std::move(v))
+template<Normalizable T>
+std::vector<T> normalize(const std::vector<T>& v, Norm kind = Norm::l2) = delete;
+
+//------------------------------------------------------------------------------
+
+} // namespace em
+
+//------------------------------------------------------------------------------
+
+#endif // NORMALIZE_HPP
+
+//------------------------------------------------------------------------------
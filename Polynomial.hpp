@@ -0,0 +1,137 @@
+//------------------------------------------------------------------------------
+
+// Polynomial из раздела 3.10 с кэшем корней, читаемым без блокировок
+
+// Корни вычисляются один раз и публикуются как неизменяемый снимок
+// (см. Lazy.hpp). Дальше читатели не берут мьютекс и не трогают счетчик
+// ссылок; visit_roots() читает корни без копирования вектора, а снимки,
+// замененные set_coefficients, освобождаются сами после чтений
+
+//------------------------------------------------------------------------------
+
+#ifndef POLYNOMIAL_HPP
+#define POLYNOMIAL_HPP
+
+//------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "Lazy.hpp"
+
+//------------------------------------------------------------------------------
+
+namespace em {
+
+//------------------------------------------------------------------------------
+// Вещественные корни a[0] + a[1]*x + ... + a[n]*x^n (метод Дюрана-Кернера)
+
+inline std::vector<double> find_real_roots(std::vector<double> a)
+{
+    while (!a.empty() && a.back() == 0.0) a.pop_back();
+    if (a.size() < 2) return {};
+
+    auto n = a.size() - 1;
+    for (auto& c : a) c /= a.back();            // Приведение к x^n + ...
+
+    using Cplx = std::complex<double>;
+    auto eval = [&a] (Cplx x)
+    {
+        Cplx r = a.back();
+        for (auto i = a.size() - 1; i-- > 0;) r = r * x + a[i];
+        return r;
+    };
+
+    std::vector<Cplx> z(n);
+    for (std::size_t i = 0; i < n; ++i)         // Начальные приближения
+        z[i] = std::pow(Cplx{0.4, 0.9}, static_cast<double>(i));
+
+    for (int iter = 0; iter < 500; ++iter) {
+        double delta = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            Cplx denom = 1.0;
+            for (std::size_t j = 0; j < n; ++j)
+                if (i != j) denom *= z[i] - z[j];
+            auto step = eval(z[i]) / denom;
+            z[i] -= step;
+            delta = std::max(delta, std::abs(step));
+        }
+        if (delta < 1e-14) break;
+    }
+
+    std::vector<double> roots;
+    for (auto r : z)
+        if (std::abs(r.imag()) <= 1e-9 * (1.0 + std::abs(r.real())))
+            roots.push_back(r.real());
+    std::sort(roots.begin(), roots.end());
+    return roots;
+}
+
+//------------------------------------------------------------------------------
+
+class Polynomial {
+public:
+    using Root_type =           // Структура данных, хранящая
+        std::vector<double>;    // значения, где полином равен нулю
+
+    Polynomial() = default;
+    explicit Polynomial(std::vector<double> coefficients)
+        : coeffs{std::move(coefficients)} {}
+
+    Polynomial(const Polynomial& rhs)
+        : coeffs{rhs.coefficients()} {}
+    Polynomial& operator=(const Polynomial& rhs)
+    {
+        if (this != &rhs) set_coefficients(rhs.coefficients());
+        return *this;
+    }
+
+    // Копия корней; после публикации - без блокировки
+    Root_type roots() const { return root_vals.get(Compute_roots{this}); }
+
+    // f(const Root_type&) над корнями без копирования вектора; результат f
+    // возвращается по значению
+    template<class F>
+    auto visit_roots(F&& f) const
+    { return root_vals.read(Compute_roots{this}, std::forward<F>(f)); }
+
+    std::vector<double> coefficients() const
+    {
+        std::lock_guard<std::mutex> g{m};
+        return coeffs;
+    }
+
+    // Запись: новые коэффициенты и сброс опубликованных корней.
+    // invalidate() вызывается вне m: внутри root_vals.get() порядок
+    // захвата обратный (мьютекс Lazy, затем m)
+    void set_coefficients(std::vector<double> coefficients)
+    {
+        {
+            std::lock_guard<std::mutex> g{m};
+            coeffs = std::move(coefficients);
+        }
+        root_vals.invalidate();
+    }
+private:
+    struct Compute_roots {
+        const Polynomial* p;
+        Root_type operator()() const { return find_real_roots(p->coefficients()); }
+    };
+
+    mutable std::mutex m;                   // Защищает coeffs
+    std::vector<double> coeffs;
+    Lazy<Root_type> root_vals;
+};
+
+//------------------------------------------------------------------------------
+
+} // namespace em
+
+//------------------------------------------------------------------------------
+
+#endif // POLYNOMIAL_HPP
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,368 @@
+//------------------------------------------------------------------------------
+
+// Пакетная проверка диапазона для between_l / between_b из раздела 6.4
+
+// between_l проверяет low_val <= val && val <= high_val по одному значению.
+// Здесь та же проверка выполняется для целого столбца (span) значений
+// int, int64, float или double и дает Bitmask; ядра SSE4/AVX2 выбираются
+// во время выполнения (Simd.hpp). Range_predicate объединяет несколько
+// диапазонов через ИЛИ (IN-список - диапазоны из одной точки) и может
+// быть инвертирован (NOT BETWEEN). Значения NaN не входят ни в один
+// диапазон, поэтому инвертированный предикат их отбирает - как !between_l
+
+//------------------------------------------------------------------------------
+
+#ifndef RANGE_SCAN_HPP
+#define RANGE_SCAN_HPP
+
+//------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <vector>
+#include "Bitmask.hpp"
+#include "Simd.hpp"
+
+//------------------------------------------------------------------------------
+
+namespace em {
+
+//------------------------------------------------------------------------------
+
+template<class T>
+struct Value_range {                    // [low, high]
+    T low;
+    T high;
+
+    bool contains(T v) const noexcept { return (low <= v) & (v <= high); }
+};
+
+//------------------------------------------------------------------------------
+// Ядра: биты low <= p[i] <= high для i < n <= 64
+
+namespace range_detail {
+
+template<class T>
+constexpr bool has_simd_lanes =
+    std::is_same_v<T, float> || std::is_same_v<T, double>
+    || (std::is_integral_v<T> && std::is_signed_v<T>
+        && (sizeof(T) == 4 || sizeof(T) == 8));
+
+template<class T>
+std::uint64_t mask_scalar(const T* p, std::size_t n, T low, T high)
+{
+    const Value_range<T> r{low, high};
+    std::uint64_t bits = 0;
+    for (std::size_t i = 0; i < n; ++i)
+        bits |= std::uint64_t{r.contains(p[i])} << i;
+    return bits;
+}
+
+#ifdef EM_SIMD_X86
+
+// Типы регистров (не через std::conditional_t: теряются атрибуты)
+template<class T> struct Vec_of { using Sse4 = __m128i; using Avx2 = __m256i; };
+template<> struct Vec_of<float> { using Sse4 = __m128; using Avx2 = __m256; };
+template<> struct Vec_of<double> { using Sse4 = __m128d; using Avx2 = __m256d; };
+
+template<class T>
+struct Sse4_range {
+    static constexpr std::size_t lanes = 16 / sizeof(T);
+
+    using Vec = typename Vec_of<T>::Sse4;
+
+    EM_TARGET_SSE4 Sse4_range(T lo, T hi)
+    {
+        if constexpr (std::is_same_v<T, float>) {
+            low = _mm_set1_ps(lo); high = _mm_set1_ps(hi);
+        }
+        else if constexpr (std::is_same_v<T, double>) {
+            low = _mm_set1_pd(lo); high = _mm_set1_pd(hi);
+        }
+        else if constexpr (sizeof(T) == 4) {
+            low = _mm_set1_epi32(lo); high = _mm_set1_epi32(hi);
+        }
+        else {
+            low = _mm_set1_epi64x(lo); high = _mm_set1_epi64x(hi);
+        }
+    }
+
+    EM_TARGET_SSE4 unsigned operator()(const T* p) const
+    {
+        if constexpr (std::is_same_v<T, float>) {
+            auto v = _mm_loadu_ps(p);
+            return unsigned(_mm_movemask_ps(
+                       _mm_and_ps(_mm_cmpge_ps(v, low), _mm_cmple_ps(v, high))));
+        }
+        else if constexpr (std::is_same_v<T, double>) {
+            auto v = _mm_loadu_pd(p);
+            return unsigned(_mm_movemask_pd(
+                       _mm_and_pd(_mm_cmpge_pd(v, low), _mm_cmple_pd(v, high))));
+        }
+        else {                          // Вне диапазона: low > v или v > high
+            auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            if constexpr (sizeof(T) == 4) {
+                auto out = _mm_or_si128(_mm_cmpgt_epi32(low, v),
+                                        _mm_cmpgt_epi32(v, high));
+                return ~unsigned(_mm_movemask_ps(_mm_castsi128_ps(out))) & 0xF;
+            }
+            else {
+                auto out = _mm_or_si128(_mm_cmpgt_epi64(low, v),
+                                        _mm_cmpgt_epi64(v, high));
+                return ~unsigned(_mm_movemask_pd(_mm_castsi128_pd(out))) & 0x3;
+            }
+        }
+    }
+
+    Vec low, high;
+};
+
+template<class T>
+struct Avx2_range {
+    static constexpr std::size_t lanes = 32 / sizeof(T);
+
+    using Vec = typename Vec_of<T>::Avx2;
+
+    EM_TARGET_AVX2 Avx2_range(T lo, T hi)
+    {
+        if constexpr (std::is_same_v<T, float>) {
+            low = _mm256_set1_ps(lo); high = _mm256_set1_ps(hi);
+        }
+        else if constexpr (std::is_same_v<T, double>) {
+            low = _mm256_set1_pd(lo); high = _mm256_set1_pd(hi);
+        }
+        else if constexpr (sizeof(T) == 4) {
+            low = _mm256_set1_epi32(lo); high = _mm256_set1_epi32(hi);
+        }
+        else {
+            low = _mm256_set1_epi64x(lo); high = _mm256_set1_epi64x(hi);
+        }
+    }
+
+    EM_TARGET_AVX2 unsigned operator()(const T* p) const
+    {
+        if constexpr (std::is_same_v<T, float>) {
+            auto v = _mm256_loadu_ps(p);
+            auto in = _mm256_and_ps(_mm256_cmp_ps(v, low, _CMP_GE_OQ),
+                                    _mm256_cmp_ps(v, high, _CMP_LE_OQ));
+            return unsigned(_mm256_movemask_ps(in));
+        }
+        else if constexpr (std::is_same_v<T, double>) {
+            auto v = _mm256_loadu_pd(p);
+            auto in = _mm256_and_pd(_mm256_cmp_pd(v, low, _CMP_GE_OQ),
+                                    _mm256_cmp_pd(v, high, _CMP_LE_OQ));
+            return unsigned(_mm256_movemask_pd(in));
+        }
+        else {
+            auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            if constexpr (sizeof(T) == 4) {
+                auto out = _mm256_or_si256(_mm256_cmpgt_epi32(low, v),
+                                           _mm256_cmpgt_epi32(v, high));
+                return ~unsigned(_mm256_movemask_ps(_mm256_castsi256_ps(out)))
+                       & 0xFF;
+            }
+            else {
+                auto out = _mm256_or_si256(_mm256_cmpgt_epi64(low, v),
+                                           _mm256_cmpgt_epi64(v, high));
+                return ~unsigned(_mm256_movemask_pd(_mm256_castsi256_pd(out)))
+                       & 0xF;
+            }
+        }
+    }
+
+    Vec low, high;
+};
+
+template<class T>
+EM_TARGET_SSE4 inline std::uint64_t mask_sse4(const T* p, std::size_t n,
+                                              T low, T high)
+{
+    const Sse4_range<T> test{low, high};
+    constexpr auto lanes = Sse4_range<T>::lanes;
+    std::uint64_t bits = 0;
+    std::size_t i = 0;
+    for (; i + lanes <= n; i += lanes)
+        bits |= std::uint64_t{test(p + i)} << i;
+    return i == n ? bits : bits | mask_scalar(p + i, n - i, low, high) << i;
+}
+
+template<class T>
+EM_TARGET_AVX2 inline std::uint64_t mask_avx2(const T* p, std::size_t n,
+                                              T low, T high)
+{
+    const Avx2_range<T> test{low, high};
+    constexpr auto lanes = Avx2_range<T>::lanes;
+    std::uint64_t bits = 0;
+    std::size_t i = 0;
+    for (; i + lanes <= n; i += lanes)
+        bits |= std::uint64_t{test(p + i)} << i;
+    return i == n ? bits : bits | mask_scalar(p + i, n - i, low, high) << i;
+}
+
+#endif // EM_SIMD_X86
+
+} // namespace range_detail
+
+template<class T>
+std::uint64_t between_bits(const T* p, std::size_t n, T low, T high,
+                           Simd_level level = simd_level())
+{
+#ifdef EM_SIMD_X86
+    if constexpr (range_detail::has_simd_lanes<T>) {
+        switch (level) {
+        case Simd_level::avx2: return range_detail::mask_avx2(p, n, low, high);
+        case Simd_level::sse4: return range_detail::mask_sse4(p, n, low, high);
+        default: break;
+        }
+    }
+#endif
+    (void)level;
+    return range_detail::mask_scalar(p, n, low, high);
+}
+
+//------------------------------------------------------------------------------
+// ИЛИ нескольких диапазонов, возможно инвертированное. Диапазоны хранятся
+// отсортированными и слитыми; при их небольшом числе каждый блок из 64
+// значений проверяется ядром на каждый диапазон, иначе - двоичным
+// поиском по диапазонам для каждого значения
+
+template<class T>
+class Range_predicate {
+public:
+    static constexpr std::size_t simd_range_limit = 8;
+
+    Range_predicate() = default;        // Пустой: не отбирает ничего
+
+    static Range_predicate between(T low, T high)
+    { return Range_predicate{}.add(low, high); }
+
+    static Range_predicate in(std::span<const T> values)
+    {
+        Range_predicate p;
+        for (auto v : values) p.push(v, v);
+        p.normalize();
+        return p;
+    }
+    static Range_predicate in(std::initializer_list<T> values)
+    { return in(std::span<const T>{values.begin(), values.size()}); }
+
+    static Range_predicate not_between(T low, T high)
+    { return between(low, high).negate(); }
+
+    // ИЛИ с диапазоном [low, high]
+    Range_predicate& add(T low, T high)
+    {
+        push(low, high);
+        normalize();
+        return *this;
+    }
+
+    Range_predicate& negate() noexcept
+    {
+        negated = !negated;
+        return *this;
+    }
+
+    const std::vector<Value_range<T>>& ranges() const noexcept { return rs; }
+    bool is_negated() const noexcept { return negated; }
+
+    bool operator()(T v) const { return contains(v) != negated; }
+
+    void select(std::span<const T> values, Bitmask& out) const
+    {
+        out.resize(values.size());
+        const auto level = simd_level();
+        const bool by_kernel = rs.size() <= simd_range_limit;
+        for (std::size_t w = 0; w < out.word_count(); ++w) {
+            auto first = w * Bitmask::word_bits;
+            const T* block = values.data() + first;
+            auto n = values.size() - first;
+            if (n > Bitmask::word_bits) n = Bitmask::word_bits;
+
+            std::uint64_t bits = 0;
+            if (by_kernel) {
+                for (const auto& r : rs)
+                    bits |= between_bits(block, n, r.low, r.high, level);
+            }
+            else {
+                for (std::size_t i = 0; i < n; ++i)
+                    bits |= std::uint64_t{contains(block[i])} << i;
+            }
+            out.data()[w] = (negated ? ~bits : bits) & out.valid_bits(w);
+        }
+    }
+
+    Bitmask select(std::span<const T> values) const
+    {
+        Bitmask out;
+        select(values, out);
+        return out;
+    }
+
+    std::size_t count(std::span<const T> values) const
+    { return select(values).count(); }
+private:
+    void push(T low, T high)
+    {
+        if (low <= high) rs.push_back({low, high});     // Пустые и NaN - нет
+    }
+
+    // Сортировка и слияние пересекающихся (для целых - и смежных) диапазонов
+    void normalize()
+    {
+        std::sort(rs.begin(), rs.end(), [] (const auto& a, const auto& b)
+        { return a.low < b.low; });
+        std::size_t out = 0;
+        for (std::size_t i = 0; i < rs.size(); ++i) {
+            if (out && touches(rs[out - 1], rs[i])) {
+                if (rs[out - 1].high < rs[i].high) rs[out - 1].high = rs[i].high;
+            }
+            else {
+                rs[out++] = rs[i];
+            }
+        }
+        rs.resize(out);
+    }
+
+    static bool touches(const Value_range<T>& a, const Value_range<T>& b)
+    {
+        if constexpr (std::is_integral_v<T>) {
+            return a.high == std::numeric_limits<T>::max()
+                   || b.low <= T(a.high + 1);
+        }
+        else {
+            return b.low <= a.high;
+        }
+    }
+
+    bool contains(T v) const
+    {
+        auto it = std::upper_bound(rs.begin(), rs.end(), v,
+                                   [] (T x, const auto& r) { return x < r.low; });
+        return it != rs.begin() && std::prev(it)->contains(v);
+    }
+
+    std::vector<Value_range<T>> rs;
+    bool negated{false};
+};
+
+// Аналог between_l для столбца значений
+template<class T>
+Bitmask between_mask(std::span<const T> values, T low, T high)
+{ return Range_predicate<T>::between(low, high).select(values); }
+
+//------------------------------------------------------------------------------
+
+} // namespace em
+
+//------------------------------------------------------------------------------
+
+#endif // RANGE_SCAN_HPP
+
+//------------------------------------------------------------------------------
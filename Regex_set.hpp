@@ -0,0 +1,739 @@
+//------------------------------------------------------------------------------
+
+// Набор регулярных выражений (как std::vector<std::regex> regexes из
+// раздела 8.2), проверяемых за один проход по тексту вместо запуска
+// каждого std::regex по очереди
+
+// Шаблоны (синтаксис ECMAScript, как у std::regex) компилируются в общий
+// НКА Томпсона, а ДКА строится лениво: состояние - множество состояний
+// НКА и множество уже совпавших шаблонов, переход вычисляется при первом
+// проходе по нему и кешируется по классам эквивалентности байтов. Поиск
+// неякорный (как std::regex_search): результат - номера шаблонов, которые
+// совпали где-либо в тексте. Scanner принимает текст фрагментами любого
+// размера; совпадения через границы фрагментов находятся. Когда в кеше
+// больше options.max_states состояний, он сбрасывается и строится заново.
+// ^ в начале и $ в конце шаблона поддерживаются (начало и конец всего
+// текста). Обратные ссылки, просмотр вперед, \b, якоря внутри шаблона
+// и прочее, что ДКА не выражает, проверяются через std::regex: для таких
+// шаблонов Scanner накапливает текст и проверяет его в finish().
+// Набор не потокобезопасен: сканеры одного набора - в одном потоке
+
+//------------------------------------------------------------------------------
+
+#ifndef REGEX_SET_HPP
+#define REGEX_SET_HPP
+
+//------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <regex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+namespace em {
+
+//------------------------------------------------------------------------------
+
+namespace regex_detail {
+
+using Byte_set = std::bitset<256>;
+
+// Конструкция, которую ДКА не выражает: шаблон проверяется std::regex
+struct Unsupported {};
+
+constexpr int max_repeat = 1000;
+constexpr std::size_t max_nfa_states = 1 << 16;     // На один шаблон
+
+struct Node {
+    enum Kind { empty, bytes, concat, alt, repeat, input_begin, input_end };
+
+    Node(Kind k = empty) noexcept : kind{k} {}
+
+    Kind kind;
+    Byte_set set;
+    std::vector<Node> kids;
+    int min{0};
+    int max{0};                 // < 0 - без ограничения
+};
+
+inline Byte_set single(unsigned char c)
+{
+    Byte_set s;
+    s.set(c);
+    return s;
+}
+
+inline Byte_set range(unsigned char lo, unsigned char hi)
+{
+    Byte_set s;
+    for (unsigned c = lo; c <= hi; ++c) s.set(c);
+    return s;
+}
+
+// Разбор подмножества ECMAScript; шаблон уже проверен std::regex
+class Parser {
+public:
+    explicit Parser(std::string_view p) noexcept : p{p} {}
+
+    Node parse()
+    {
+        auto n = alternation();
+        if (more()) throw Unsupported{};
+        return n;
+    }
+private:
+    bool more() const noexcept { return i < p.size(); }
+    char peek() const noexcept { return p[i]; }
+
+    Node alternation()
+    {
+        auto n = concatenation();
+        if (!more() || peek() != '|') return n;
+        Node a{Node::alt};
+        a.kids.push_back(std::move(n));
+        while (more() && peek() == '|') {
+            ++i;
+            a.kids.push_back(concatenation());
+        }
+        return a;
+    }
+
+    Node concatenation()
+    {
+        Node c{Node::concat};
+        while (more() && peek() != '|' && peek() != ')') c.kids.push_back(repetition());
+        return c;
+    }
+
+    Node repetition()
+    {
+        auto a = atom();
+        while (more()) {
+            int lo, hi;
+            switch (peek()) {
+            case '*': lo = 0; hi = -1; ++i; break;
+            case '+': lo = 1; hi = -1; ++i; break;
+            case '?': lo = 0; hi = 1; ++i; break;
+            case '{':
+                if (bounds(lo, hi)) break;
+                return a;
+            default:
+                return a;
+            }
+            if (more() && peek() == '?') ++i;   // Ленивость не меняет, совпал ли шаблон
+            if (a.kind == Node::input_begin || a.kind == Node::input_end) throw Unsupported{};
+
+            Node r{Node::repeat};
+            r.min = lo;
+            r.max = hi;
+            r.kids.push_back(std::move(a));
+            a = std::move(r);
+        }
+        return a;
+    }
+
+    // {m}, {m,}, {m,n}
+    bool bounds(int& lo, int& hi)
+    {
+        auto start = i++;
+        if (!number(lo)) { i = start; return false; }
+        hi = lo;
+        if (more() && peek() == ',') {
+            ++i;
+            hi = -1;
+            if (more() && peek() != '}' && !number(hi)) { i = start; return false; }
+        }
+        if (!more() || peek() != '}') { i = start; return false; }
+        ++i;
+        if (lo > max_repeat || hi > max_repeat || (hi >= 0 && hi < lo)) throw Unsupported{};
+        return true;
+    }
+
+    bool number(int& v)
+    {
+        if (!more() || peek() < '0' || peek() > '9') return false;
+        v = 0;
+        while (more() && peek() >= '0' && peek() <= '9') {
+            v = std::min(v * 10 + (peek() - '0'), max_repeat + 1);
+            ++i;
+        }
+        return true;
+    }
+
+    Node atom()
+    {
+        auto c = p[i++];
+        switch (c) {
+        case '(': {
+            if (more() && peek() == '?') {
+                if (i + 1 < p.size() && p[i + 1] == ':') i += 2;
+                else throw Unsupported{};                       // (?= (?!
+            }
+            auto n = alternation();
+            if (!more() || peek() != ')') throw Unsupported{};
+            ++i;
+            return n;
+        }
+        case '[': return bytes(klass());
+        case '.': {
+            Byte_set s;
+            s.set();
+            s.reset('\n');
+            s.reset('\r');
+            return bytes(s);
+        }
+        case '^': return Node{Node::input_begin};
+        case '$': return Node{Node::input_end};
+        case '\\': return bytes(escape(false));
+        case '*': case '+': case '?': case ')': throw Unsupported{};
+        default: return bytes(single(static_cast<unsigned char>(c)));
+        }
+    }
+
+    static Node bytes(const Byte_set& s)
+    {
+        Node n{Node::bytes};
+        n.set = s;
+        return n;
+    }
+
+    Byte_set escape(bool in_class)
+    {
+        if (!more()) throw Unsupported{};
+        auto c = p[i++];
+        switch (c) {
+        case 'd': return range('0', '9');
+        case 'D': return ~range('0', '9');
+        case 'w': return word();
+        case 'W': return ~word();
+        case 's': return space();
+        case 'S': return ~space();
+        case 'n': return single('\n');
+        case 't': return single('\t');
+        case 'r': return single('\r');
+        case 'v': return single('\v');
+        case 'f': return single('\f');
+        case '0':
+            if (more() && peek() >= '0' && peek() <= '9') throw Unsupported{};
+            return single('\0');
+        case 'x': {
+            if (i + 2 > p.size()) throw Unsupported{};
+            auto v = hex(p[i]) * 16 + hex(p[i + 1]);
+            i += 2;
+            return single(static_cast<unsigned char>(v));
+        }
+        case 'b':
+            if (in_class) return single('\b');
+            throw Unsupported{};
+        default:
+            // Обратные ссылки, \B, \c, \u и прочее
+            if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'))
+                throw Unsupported{};
+            return single(static_cast<unsigned char>(c));
+        }
+    }
+
+    static int hex(char c)
+    {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        throw Unsupported{};
+    }
+
+    static Byte_set word()
+    { return range('a', 'z') | range('A', 'Z') | range('0', '9') | single('_'); }
+
+    static Byte_set space()
+    { return single(' ') | range('\t', '\r'); }
+
+    Byte_set klass()
+    {
+        Byte_set s;
+        bool negate = more() && peek() == '^';
+        if (negate) ++i;
+        if (more() && peek() == ']') throw Unsupported{};      // [] и [^]
+        for (;;) {
+            if (!more()) throw Unsupported{};
+            auto c = p[i++];
+            if (c == ']') break;
+            if (c == '[' && more() && (peek() == ':' || peek() == '=' || peek() == '.'))
+                throw Unsupported{};
+
+            auto item = c == '\\' ? escape(true) : single(static_cast<unsigned char>(c));
+            if (i + 1 < p.size() && p[i] == '-' && p[i + 1] != ']') {
+                ++i;
+                auto d = p[i++];
+                auto last = d == '\\' ? escape(true) : single(static_cast<unsigned char>(d));
+                auto lo = only(item);
+                auto hi = only(last);
+                if (hi < lo) throw Unsupported{};
+                s |= range(lo, hi);
+            }
+            else {
+                s |= item;
+            }
+        }
+        return negate ? ~s : s;
+    }
+
+    // Единственный байт множества (граница диапазона)
+    static unsigned char only(const Byte_set& s)
+    {
+        if (s.count() != 1) throw Unsupported{};
+        unsigned c = 0;
+        while (!s.test(c)) ++c;
+        return static_cast<unsigned char>(c);
+    }
+
+    std::string_view p;
+    std::size_t i{0};
+};
+
+inline bool has_anchor(const Node& n) noexcept
+{
+    if (n.kind == Node::input_begin || n.kind == Node::input_end) return true;
+    return std::any_of(n.kids.begin(), n.kids.end(), has_anchor);
+}
+
+//------------------------------------------------------------------------------
+// НКА Томпсона всех шаблонов набора
+
+struct Nfa_state {
+    enum Kind : std::uint8_t { bytes, split, match, end_match };
+
+    Kind kind;
+    int set;                    // bytes: индекс в Nfa::sets
+    int out;
+    int out1;                   // split: вторая ветвь
+    int pattern;
+};
+
+struct Nfa {
+    std::vector<Nfa_state> states;
+    std::vector<Byte_set> sets;
+
+    int add(Nfa_state::Kind kind, int pattern, int out = -1, int out1 = -1, int set = -1)
+    {
+        if (states.size() - first >= max_nfa_states) throw Unsupported{};
+        states.push_back({kind, set, out, out1, pattern});
+        return int(states.size() - 1);
+    }
+
+    // Вход фрагмента n, который по завершении переходит в out
+    int compile(const Node& n, int out, int pattern)
+    {
+        switch (n.kind) {
+        case Node::bytes:
+            sets.push_back(n.set);
+            return add(Nfa_state::bytes, pattern, out, -1, int(sets.size() - 1));
+        case Node::concat:
+            for (auto k = n.kids.rbegin(); k != n.kids.rend(); ++k) out = compile(*k, out, pattern);
+            return out;
+        case Node::alt: {
+            auto entry = compile(n.kids.back(), out, pattern);
+            for (auto k = n.kids.rbegin() + 1; k != n.kids.rend(); ++k)
+                entry = add(Nfa_state::split, pattern, compile(*k, out, pattern), entry);
+            return entry;
+        }
+        case Node::repeat: {
+            const auto& kid = n.kids.front();
+            auto entry = out;
+            if (n.max < 0) {                            // kid*
+                auto loop = add(Nfa_state::split, pattern, -1, out);
+                states[loop].out = compile(kid, loop, pattern);
+                entry = loop;
+            }
+            else {                                      // (kid(kid)?)?...
+                for (int k = n.min; k < n.max; ++k)
+                    entry = add(Nfa_state::split, pattern, compile(kid, entry, pattern), out);
+            }
+            for (int k = 0; k < n.min; ++k) entry = compile(kid, entry, pattern);
+            return entry;
+        }
+        default:
+            return out;
+        }
+    }
+
+    // Начало шаблона: превышение max_nfa_states считается от него
+    std::size_t first{0};
+};
+
+} // namespace regex_detail
+
+//------------------------------------------------------------------------------
+
+struct Regex_set_options {
+    std::size_t max_states{4096};           // Состояний ДКА в кеше
+};
+
+class Regex_set {
+public:
+    class Scanner;
+
+    explicit Regex_set(Regex_set_options o = {}) : opts{o} {}
+
+    Regex_set(const Regex_set&) = delete;
+    Regex_set& operator=(const Regex_set&) = delete;
+
+    // Номер нового шаблона; std::regex_error для некорректного шаблона
+    std::size_t add(std::string_view pattern)
+    {
+        using namespace regex_detail;
+
+        std::regex checked{pattern.begin(), pattern.end()};     // Проверка синтаксиса
+        Pattern pat;
+        auto id = int(patterns.size());
+        auto n_states = nfa.states.size();
+        auto n_sets = nfa.sets.size();
+        try {
+            auto ast = Parser{pattern}.parse();
+            strip_anchors(ast, pat);
+            if (has_anchor(ast)) throw Unsupported{};
+
+            nfa.first = n_states;
+            auto m = nfa.add(pat.anchored_end ? Nfa_state::end_match : Nfa_state::match, id);
+            pat.start = nfa.compile(ast, m, id);
+        }
+        catch (const Unsupported&) {
+            nfa.states.resize(n_states);
+            nfa.sets.resize(n_sets);
+            pat = Pattern{};
+            pat.fallback.emplace(std::move(checked));
+        }
+        patterns.push_back(std::move(pat));
+        reset_dfa();
+        compiled = false;
+        return std::size_t(id);
+    }
+
+    std::size_t size() const noexcept { return patterns.size(); }
+
+    // Шаблон проверяется std::regex, а не ДКА
+    bool uses_fallback(std::size_t id) const { return patterns.at(id).fallback.has_value(); }
+
+    // Построенных состояний ДКА
+    std::size_t dfa_states() const noexcept { return states.size(); }
+
+    inline Scanner scanner();
+
+    // Номера шаблонов, совпавших где-либо в text, по возрастанию
+    inline std::vector<std::size_t> match(std::string_view text);
+private:
+    using State_id = std::int32_t;
+
+    struct Pattern {
+        int start{-1};
+        bool anchored_begin{false};
+        bool anchored_end{false};
+        std::optional<std::regex> fallback;
+    };
+
+    struct State {
+        std::string key;                    // matched, затем core
+        std::vector<std::uint64_t> matched;
+        std::vector<int> core;              // bytes и end_match, по возрастанию
+        bool done;                          // Переходы больше ничего не изменят
+    };
+
+    static void strip_anchors(regex_detail::Node& ast, Pattern& pat)
+    {
+        using regex_detail::Node;
+        if (ast.kind == Node::input_begin) { pat.anchored_begin = true; ast = Node{}; }
+        else if (ast.kind == Node::input_end) { pat.anchored_end = true; ast = Node{}; }
+        if (ast.kind != Node::concat) return;
+        auto& k = ast.kids;
+        if (!k.empty() && k.front().kind == Node::input_begin) {
+            pat.anchored_begin = true;
+            k.erase(k.begin());
+        }
+        if (!k.empty() && k.back().kind == Node::input_end) {
+            pat.anchored_end = true;
+            k.pop_back();
+        }
+    }
+
+    void reset_dfa()
+    {
+        states.clear();
+        index.clear();
+        trans.clear();
+        start_id = -1;
+        ++generation;
+    }
+
+    // Классы эквивалентности байтов по всем множествам НКА
+    void compile()
+    {
+        std::unordered_map<std::string, std::uint8_t> classes;
+        std::string signature(nfa.sets.size(), '\0');
+        n_classes = 0;
+        for (unsigned b = 0; b < 256; ++b) {
+            for (std::size_t s = 0; s < nfa.sets.size(); ++s) signature[s] = nfa.sets[s].test(b);
+            auto [it, fresh] = classes.try_emplace(signature, std::uint8_t(n_classes));
+            if (fresh) representative[n_classes++] = std::uint8_t(b);
+            byte_class[b] = it->second;
+        }
+        words = (patterns.size() + 63) / 64;
+        marks.assign(nfa.states.size(), 0);
+        compiled = true;
+    }
+
+    static bool test(const std::vector<std::uint64_t>& bits, int i) noexcept
+    { return bits[std::size_t(i) / 64] >> (i % 64) & 1; }
+
+    // Замыкание по eps-переходам; состояния совпавших шаблонов отбрасываются
+    void closure(std::vector<int>& stack, std::vector<std::uint64_t>& matched,
+                 std::vector<int>& core)
+    {
+        using regex_detail::Nfa_state;
+        if (++stamp == 0) {
+            std::fill(marks.begin(), marks.end(), 0);
+            stamp = 1;
+        }
+        while (!stack.empty()) {
+            auto x = stack.back();
+            stack.pop_back();
+            if (marks[x] == stamp) continue;
+            marks[x] = stamp;
+            const auto& st = nfa.states[x];
+            if (test(matched, st.pattern)) continue;
+            switch (st.kind) {
+            case Nfa_state::split:
+                stack.push_back(st.out1);
+                stack.push_back(st.out);
+                break;
+            case Nfa_state::match:
+                matched[std::size_t(st.pattern) / 64] |= std::uint64_t{1} << (st.pattern % 64);
+                break;
+            default:
+                core.push_back(x);
+                break;
+            }
+        }
+        std::erase_if(core, [&] (int x) { return test(matched, nfa.states[x].pattern); });
+        std::sort(core.begin(), core.end());
+    }
+
+    // Начала шаблонов без ^ (initial - всех), еще не совпавших
+    void push_starts(std::vector<int>& stack, const std::vector<std::uint64_t>& matched,
+                     bool initial) const
+    {
+        for (std::size_t p = 0; p < patterns.size(); ++p) {
+            const auto& pat = patterns[p];
+            if (pat.start >= 0 && (initial || !pat.anchored_begin) && !test(matched, int(p)))
+                stack.push_back(pat.start);
+        }
+    }
+
+    State_id intern(std::vector<std::uint64_t>&& matched, std::vector<int>&& core)
+    {
+        std::string key;
+        key.reserve(matched.size() * 8 + core.size() * 4);
+        key.append(reinterpret_cast<const char*>(matched.data()), matched.size() * 8);
+        key.append(reinterpret_cast<const char*>(core.data()), core.size() * 4);
+        if (auto it = index.find(key); it != index.end()) return it->second;
+
+        std::vector<int> stack;
+        push_starts(stack, matched, false);
+        bool done = core.empty() && stack.empty();
+
+        auto id = State_id(states.size());
+        index.emplace(key, id);
+        states.push_back({std::move(key), std::move(matched), std::move(core), done});
+        trans.resize(states.size() * n_classes, -1);
+        return id;
+    }
+
+    State_id intern_key(const std::string& key)
+    {
+        std::vector<std::uint64_t> matched(words);
+        std::vector<int> core((key.size() - words * 8) / 4);
+        std::copy_n(key.data(), words * 8, reinterpret_cast<char*>(matched.data()));
+        std::copy_n(key.data() + words * 8, core.size() * 4, reinterpret_cast<char*>(core.data()));
+        return intern(std::move(matched), std::move(core));
+    }
+
+    State_id start()
+    {
+        if (!compiled) compile();
+        if (start_id < 0) {
+            std::vector<std::uint64_t> matched(words);
+            std::vector<int> core, stack;
+            push_starts(stack, matched, true);
+            closure(stack, matched, core);
+            start_id = intern(std::move(matched), std::move(core));
+        }
+        return start_id;
+    }
+
+    // Переход из s по классу c; при переполнении кеш сбрасывается
+    State_id build(State_id s, std::uint8_t c)
+    {
+        using regex_detail::Nfa_state;
+        if (states.size() >= opts.max_states) {
+            auto key = states[s].key;
+            auto start_key = states[start_id].key;
+            reset_dfa();
+            start_id = intern_key(start_key);
+            s = intern_key(key);
+        }
+
+        auto matched = states[s].matched;
+        std::vector<int> core, stack;
+        auto b = representative[c];
+        for (auto x : states[s].core) {
+            const auto& st = nfa.states[x];
+            if (st.kind == Nfa_state::bytes && nfa.sets[st.set].test(b)) stack.push_back(st.out);
+        }
+        push_starts(stack, matched, false);
+        closure(stack, matched, core);
+        auto next = intern(std::move(matched), std::move(core));
+        trans[std::size_t(s) * n_classes + c] = State_id(next * n_classes);
+        return next;
+    }
+
+    Regex_set_options opts;
+    std::vector<Pattern> patterns;
+    regex_detail::Nfa nfa;
+
+    bool compiled{false};
+    std::array<std::uint8_t, 256> byte_class{};
+    std::array<std::uint8_t, 256> representative{};
+    std::size_t n_classes{0};
+    std::size_t words{0};
+    std::vector<std::uint32_t> marks;
+    std::uint32_t stamp{0};
+
+    std::vector<State> states;
+    std::unordered_map<std::string, State_id> index;
+    std::vector<State_id> trans;            // states x n_classes: номер строки
+                                            // перехода (id * n_classes), -1 - не построен
+    State_id start_id{-1};
+    std::size_t generation{0};              // Меняется при сбросе кеша
+};
+
+//------------------------------------------------------------------------------
+
+// Проверка текста, поступающего фрагментами
+class Regex_set::Scanner {
+public:
+    explicit Scanner(Regex_set& set) : set{&set}, n_patterns{set.size()} { restart(); }
+
+    void feed(std::string_view chunk)
+    {
+        auto& rs = *set;
+        sync();
+        const auto* p = reinterpret_cast<const unsigned char*>(chunk.data());
+        const auto n = chunk.size();
+        const auto classes = rs.n_classes;
+        const auto* byte_class = rs.byte_class.data();
+        const auto* trans = rs.trans.data();
+        auto row = std::size_t(state) * classes;    // Строка trans текущего состояния
+        std::size_t i = 0;
+        while (i < n && !rs.states[row / classes].done) {
+            auto end = std::min(n, i + 256);        // done проверяется реже
+            for (; i < end; ++i) {
+                auto c = byte_class[p[i]];
+                auto next = trans[row + c];
+                if (next < 0) {
+                    next = State_id(rs.build(State_id(row / classes), c) * classes);
+                    trans = rs.trans.data();
+                }
+                row = std::size_t(next);
+            }
+        }
+        auto s = State_id(row / classes);
+        state = s;
+        generation = rs.generation;
+        key = rs.states[s].key;
+        if (fallbacks) text.append(chunk);
+    }
+
+    // Номера шаблонов, совпавших в тексте с начала или с прошлого
+    // finish(), по возрастанию; затем сканер готов к новому тексту
+    std::vector<std::size_t> finish()
+    {
+        using regex_detail::Nfa_state;
+        auto& rs = *set;
+        sync();
+        const auto& st = rs.states[state];
+        std::vector<std::size_t> ids;
+        for (std::size_t p = 0; p < rs.patterns.size(); ++p) {
+            const auto& pat = rs.patterns[p];
+            bool hit = pat.fallback ? std::regex_search(text, *pat.fallback)
+                                    : Regex_set::test(st.matched, int(p));
+            if (hit) ids.push_back(p);
+        }
+        for (auto x : st.core) {
+            const auto& ns = rs.nfa.states[x];
+            if (ns.kind == Nfa_state::end_match) ids.push_back(std::size_t(ns.pattern));
+        }
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+        restart();
+        return ids;
+    }
+private:
+    void restart()
+    {
+        if (set->size() != n_patterns)
+            throw std::logic_error{"Regex_set::Scanner: шаблоны добавлены после создания"};
+        state = set->start();
+        generation = set->generation;
+        key = set->states[state].key;
+        fallbacks = std::any_of(set->patterns.begin(), set->patterns.end(),
+                                [] (const Pattern& p) { return p.fallback.has_value(); });
+        text.clear();
+    }
+
+    // Кеш мог быть сброшен другим сканером
+    void sync()
+    {
+        if (set->size() != n_patterns)
+            throw std::logic_error{"Regex_set::Scanner: шаблоны добавлены после создания"};
+        if (generation == set->generation) return;
+        set->start();
+        state = set->intern_key(key);
+        generation = set->generation;
+    }
+
+    Regex_set* set;
+    std::size_t n_patterns;
+    State_id state{0};
+    std::size_t generation{0};
+    std::string key;                        // Состояние на случай сброса кеша
+    bool fallbacks{false};
+    std::string text;                       // Только для шаблонов std::regex
+};
+
+inline Regex_set::Scanner Regex_set::scanner() { return Scanner{*this}; }
+
+inline std::vector<std::size_t> Regex_set::match(std::string_view text)
+{
+    Scanner s{*this};
+    s.feed(text);
+    return s.finish();
+}
+
+//------------------------------------------------------------------------------
+
+} // namespace em
+
+//------------------------------------------------------------------------------
+
+#endif // REGEX_SET_HPP
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,97 @@
+//------------------------------------------------------------------------------
+
+// Счетчик статистики, разнесенный по кэш-линиям; замена
+// mutable std::atomic<unsigned> call_count из раздела 3.10
+
+// Один общий атомарный счетчик заставляет кэш-линию метаться между
+// ядрами при каждом инкременте. Здесь каждый поток получает свой шард
+// (отдельную кэш-линию) и увеличивает только его; сумма собирается при
+// чтении. Чтение поэтому дороже и не является мгновенным снимком, что
+// для статистики допустимо
+
+//------------------------------------------------------------------------------
+
+#ifndef SHARDED_COUNTER_HPP
+#define SHARDED_COUNTER_HPP
+
+//------------------------------------------------------------------------------
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+//------------------------------------------------------------------------------
+
+namespace em {
+
+//------------------------------------------------------------------------------
+
+constexpr std::size_t cache_line_size = 64;
+
+// Порядковый номер потока; шарды раздаются потокам по кругу
+inline std::size_t thread_shard_seed() noexcept
+{
+    static std::atomic<std::size_t> next{0};
+    thread_local const std::size_t seed =
+            next.fetch_add(1, std::memory_order_relaxed);
+    return seed;
+}
+
+//------------------------------------------------------------------------------
+// Shards - степень двойки. Занимает Shards * cache_line_size байт, поэтому
+// предназначен для общих (static) счетчиков, а не для членов каждого
+// мелкого объекта вроде Point
+
+template<class T = std::uint64_t, std::size_t Shards = 32>
+class Sharded_counter {
+    static_assert(std::is_integral_v<T>);
+    static_assert(Shards && (Shards & (Shards - 1)) == 0,
+                  "Число шардов должно быть степенью двойки");
+public:
+    Sharded_counter() = default;
+    Sharded_counter(const Sharded_counter&) = delete;
+    Sharded_counter& operator=(const Sharded_counter&) = delete;
+
+    void add(T n = 1) noexcept
+    {
+        shards[thread_shard_seed() & (Shards - 1)]
+                .value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    Sharded_counter& operator++() noexcept { add(); return *this; }
+    Sharded_counter& operator+=(T n) noexcept { add(n); return *this; }
+
+    // Сумма по шардам
+    T load() const noexcept
+    {
+        T sum{0};
+        for (const auto& s : shards)
+            sum += s.value.load(std::memory_order_relaxed);
+        return sum;
+    }
+
+    operator T() const noexcept { return load(); }
+
+    // Обнуление; инкременты, идущие параллельно, могут быть потеряны
+    void reset() noexcept
+    {
+        for (auto& s : shards) s.value.store(0, std::memory_order_relaxed);
+    }
+private:
+    struct alignas(cache_line_size) Shard {
+        std::atomic<T> value{0};
+    };
+
+    Shard shards[Shards];
+};
+
+//------------------------------------------------------------------------------
+
+} // namespace em
+
+//------------------------------------------------------------------------------
+
+#endif // SHARDED_COUNTER_HPP
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,79 @@
+//------------------------------------------------------------------------------
+
+// Выбор SIMD-ядер во время выполнения
+
+// Ядра с интринсиками компилируются для своего набора инструкций атрибутом
+// EM_TARGET_AVX2 / EM_TARGET_SSE4, поэтому весь проект по-прежнему собирается
+// без -mavx2. simd_level() один раз определяет возможности процессора;
+// set_simd_limit() позволяет ограничить уровень (сравнение ядер в
+// бенчмарках). Вне x86 с GCC/Clang доступны только скалярные ядра
+
+//------------------------------------------------------------------------------
+
+#ifndef SIMD_HPP
+#define SIMD_HPP
+
+//------------------------------------------------------------------------------
+
+#include <atomic>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define EM_SIMD_X86 1
+#include <immintrin.h>
+#define EM_TARGET_AVX2 __attribute__((target("avx2")))
+#define EM_TARGET_SSE4 __attribute__((target("sse4.2")))
+#endif
+
+//------------------------------------------------------------------------------
+
+namespace em {
+
+//------------------------------------------------------------------------------
+
+enum class Simd_level { scalar, sse4, avx2 };
+
+inline const char* to_string(Simd_level l) noexcept
+{
+    switch (l) {
+    case Simd_level::avx2: return "avx2";
+    case Simd_level::sse4: return "sse4";
+    default:               return "scalar";
+    }
+}
+
+namespace simd_detail {
+
+inline Simd_level detect() noexcept
+{
+#ifdef EM_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return Simd_level::avx2;
+    if (__builtin_cpu_supports("sse4.2")) return Simd_level::sse4;
+#endif
+    return Simd_level::scalar;
+}
+
+inline std::atomic<Simd_level> limit{Simd_level::avx2};
+
+} // namespace simd_detail
+
+// Уровень, доступный ядрам: возможности процессора с учетом ограничения
+inline Simd_level simd_level() noexcept
+{
+    static const Simd_level detected = simd_detail::detect();
+    auto lim = simd_detail::limit.load(std::memory_order_relaxed);
+    return lim < detected ? lim : detected;
+}
+
+inline void set_simd_limit(Simd_level l) noexcept
+{ simd_detail::limit.store(l, std::memory_order_relaxed); }
+
+//------------------------------------------------------------------------------
+
+} // namespace em
+
+//------------------------------------------------------------------------------
+
+#endif // SIMD_HPP
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,209 @@
+//------------------------------------------------------------------------------
+
+// Пул блоков по классам размеров (slab-аллокатор) для мелких объектов,
+// которые массово создаются и уничтожаются (иерархия Investment, 4.1)
+
+// Память нарезается из блоков slab_bytes на ячейки одного класса размера.
+// У каждого потока свои списки свободных ячеек, поэтому выделение и
+// освобождение обычно сводятся к операции над односвязным списком без
+// блокировок. Общий мьютекс берется только при пополнении или сбросе
+// излишков (пачками по batch ячеек). Память пулу обратно ОС не отдается
+
+//------------------------------------------------------------------------------
+
+#ifndef SLAB_POOL_HPP
+#define SLAB_POOL_HPP
+
+//------------------------------------------------------------------------------
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+namespace em {
+
+//------------------------------------------------------------------------------
+
+class Slab_pool {
+public:
+    static constexpr std::size_t granularity = alignof(std::max_align_t);
+    static constexpr std::size_t max_size = 512;    // Крупнее - в ::operator new
+    static constexpr std::size_t classes = max_size / granularity;
+    static constexpr std::size_t slab_bytes = 64 * 1024;
+    static constexpr std::size_t batch = 64;        // Ячеек за обмен с общим пулом
+
+    static void* allocate(std::size_t n)
+    {
+        if (n == 0) n = 1;
+        if (n > max_size) return ::operator new(n);
+        auto c = class_of(n);
+        auto* tc = local();
+        if (!tc) return take_global(c);
+        if (!tc->heads[c]) refill(*tc, c);
+        auto* b = tc->heads[c];
+        tc->heads[c] = b->next;
+        --tc->counts[c];
+        return b;
+    }
+
+    // n - тот же размер, что и при выделении
+    static void deallocate(void* p, std::size_t n) noexcept
+    {
+        if (!p) return;
+        if (n == 0) n = 1;
+        if (n > max_size) { ::operator delete(p); return; }
+        auto c = class_of(n);
+        auto* b = static_cast<Free_block*>(p);
+        auto* tc = local();
+        if (!tc) { put_global(b, c); return; }
+        b->next = tc->heads[c];
+        tc->heads[c] = b;
+        if (++tc->counts[c] > 2 * batch) release(*tc, c, batch);
+    }
+
+    // Всего байт, нарезанных из slab-блоков
+    static std::size_t reserved_bytes()
+    {
+        auto& g = global();
+        std::lock_guard<std::mutex> lock{g.m};
+        return g.slabs.size() * slab_bytes;
+    }
+private:
+    struct Free_block { Free_block* next; };
+
+    static std::size_t class_of(std::size_t n) noexcept
+    { return (n + granularity - 1) / granularity - 1; }
+
+    struct Global {
+        std::mutex m;
+        Free_block* heads[classes]{};
+        std::vector<std::unique_ptr<char[]>> slabs;
+    };
+
+    // Никогда не уничтожается: объекты могут освобождаться
+    // и после завершения статической деструкции
+    static Global& global()
+    {
+        static Global* g = new Global;
+        return *g;
+    }
+
+    struct Thread_cache {
+        Free_block* heads[classes]{};
+        std::size_t counts[classes]{};
+
+        ~Thread_cache()                 // Возврат ячеек в общий пул
+        {
+            for (std::size_t c = 0; c < classes; ++c)
+                if (counts[c]) release(*this, c, counts[c]);
+            destroyed() = true;
+        }
+    };
+
+    // Тривиальный флаг переживает Thread_cache: после его уничтожения
+    // (деструкторы объектов при завершении потока) работаем с общим пулом
+    static bool& destroyed() noexcept
+    {
+        thread_local bool flag{false};
+        return flag;
+    }
+
+    static Thread_cache* local()
+    {
+        if (destroyed()) return nullptr;
+        thread_local Thread_cache tc;
+        return &tc;
+    }
+
+    // Нарезка нового slab-блока в список head; вызывается под g.m
+    static std::size_t carve(Global& g, Free_block*& head, std::size_t c)
+    {
+        auto size = (c + 1) * granularity;
+        g.slabs.push_back(std::make_unique<char[]>(slab_bytes));
+        auto* base = g.slabs.back().get();
+        std::size_t n = 0;
+        for (auto off = slab_bytes / size * size; off != 0; ++n) {
+            off -= size;
+            auto* b = reinterpret_cast<Free_block*>(base + off);
+            b->next = head;
+            head = b;
+        }
+        return n;
+    }
+
+    static void* take_global(std::size_t c)
+    {
+        auto& g = global();
+        std::lock_guard<std::mutex> lock{g.m};
+        if (!g.heads[c]) carve(g, g.heads[c], c);
+        auto* b = g.heads[c];
+        g.heads[c] = b->next;
+        return b;
+    }
+
+    static void put_global(Free_block* b, std::size_t c) noexcept
+    {
+        auto& g = global();
+        std::lock_guard<std::mutex> lock{g.m};
+        b->next = g.heads[c];
+        g.heads[c] = b;
+    }
+
+    static void refill(Thread_cache& tc, std::size_t c)
+    {
+        auto& g = global();
+        std::lock_guard<std::mutex> lock{g.m};
+        for (std::size_t i = 0; i < batch && g.heads[c]; ++i) {
+            auto* b = g.heads[c];
+            g.heads[c] = b->next;
+            b->next = tc.heads[c];
+            tc.heads[c] = b;
+            ++tc.counts[c];
+        }
+        if (tc.heads[c]) return;
+
+        // Новый slab-блок целиком уходит в список потока
+        tc.counts[c] += carve(g, tc.heads[c], c);
+    }
+
+    static void release(Thread_cache& tc, std::size_t c, std::size_t n)
+    {
+        auto& g = global();
+        std::lock_guard<std::mutex> lock{g.m};
+        for (; n && tc.heads[c]; --n) {
+            auto* b = tc.heads[c];
+            tc.heads[c] = b->next;
+            b->next = g.heads[c];
+            g.heads[c] = b;
+            --tc.counts[c];
+        }
+    }
+};
+
+//------------------------------------------------------------------------------
+// База, направляющая new/delete наследников в Slab_pool. При виртуальном
+// деструкторе delete через указатель на базу получает размер
+// динамического типа, поэтому ячейка возвращается в свой класс размера.
+// Типы с выравниванием больше alignof(std::max_align_t) не поддерживаются
+
+struct Slab_allocated {
+    static void* operator new(std::size_t n)
+    { return Slab_pool::allocate(n); }
+
+    static void operator delete(void* p, std::size_t n) noexcept
+    { Slab_pool::deallocate(p, n); }
+};
+
+//------------------------------------------------------------------------------
+
+} // namespace em
+
+//------------------------------------------------------------------------------
+
+#endif // SLAB_POOL_HPP
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,154 @@
+//------------------------------------------------------------------------------
+
+// Task<T>: сопрограмма C++20 с результатом T вместо цепочек обратных
+// вызовов и std::bind из раздела 6.4
+
+// Задача ленивая: тело начинает выполняться при co_await, а по завершении
+// управление передается ожидающей сопрограмме симметрично, без роста
+// стека. Исключение из тела сохраняется и выбрасывается в ожидающем.
+// Кадры сопрограмм выделяются из Slab_pool (кадры до 512 байт), поэтому
+// тысячи одновременно ожидающих задач не нагружают общий malloc
+
+//------------------------------------------------------------------------------
+
+#ifndef TASK_HPP
+#define TASK_HPP
+
+//------------------------------------------------------------------------------
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+#include "Slab_pool.hpp"
+
+//------------------------------------------------------------------------------
+
+namespace em {
+
+//------------------------------------------------------------------------------
+
+template<class T = void>
+class Task;
+
+namespace task_detail {
+
+struct Promise_base : Slab_allocated {
+    struct Final_awaiter {
+        bool await_ready() const noexcept { return false; }
+
+        template<class P>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h) noexcept
+        { return h.promise().continuation; }
+
+        void await_resume() const noexcept {}
+    };
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    Final_awaiter final_suspend() const noexcept { return {}; }
+    void unhandled_exception() noexcept { error = std::current_exception(); }
+
+    std::coroutine_handle<> continuation{std::noop_coroutine()};
+    std::exception_ptr error;
+};
+
+template<class T>
+struct Promise : Promise_base {
+    Task<T> get_return_object() noexcept;
+
+    template<class U>
+    void return_value(U&& v) { value.emplace(std::forward<U>(v)); }
+
+    T result()
+    {
+        if (error) std::rethrow_exception(error);
+        return std::move(*value);
+    }
+
+    std::optional<T> value;
+};
+
+template<>
+struct Promise<void> : Promise_base {
+    Task<void> get_return_object() noexcept;
+
+    void return_void() const noexcept {}
+
+    void result() const
+    {
+        if (error) std::rethrow_exception(error);
+    }
+};
+
+} // namespace task_detail
+
+//------------------------------------------------------------------------------
+
+template<class T>
+class [[nodiscard]] Task {
+public:
+    using promise_type = task_detail::Promise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    Task() noexcept = default;
+    explicit Task(Handle h) noexcept : h{h} {}
+
+    Task(Task&& rhs) noexcept : h{std::exchange(rhs.h, {})} {}
+
+    Task& operator=(Task&& rhs) noexcept
+    {
+        if (this != &rhs) {
+            if (h) h.destroy();
+            h = std::exchange(rhs.h, {});
+        }
+        return *this;
+    }
+
+    ~Task() { if (h) h.destroy(); }
+
+    bool valid() const noexcept { return static_cast<bool>(h); }
+    bool done() const noexcept { return h && h.done(); }
+
+    auto operator co_await() const noexcept
+    {
+        struct Awaiter {
+            Handle h;
+
+            bool await_ready() const noexcept { return !h || h.done(); }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+            {
+                h.promise().continuation = awaiting;
+                return h;
+            }
+
+            T await_resume() const { return h.promise().result(); }
+        };
+        return Awaiter{h};
+    }
+private:
+    Handle h;
+};
+
+//------------------------------------------------------------------------------
+
+namespace task_detail {
+
+template<class T>
+Task<T> Promise<T>::get_return_object() noexcept
+{ return Task<T>{std::coroutine_handle<Promise>::from_promise(*this)}; }
+
+inline Task<void> Promise<void>::get_return_object() noexcept
+{ return Task<void>{std::coroutine_handle<Promise>::from_promise(*this)}; }
+
+} // namespace task_detail
+
+//------------------------------------------------------------------------------
+
+} // namespace em
+
+//------------------------------------------------------------------------------
+
+#endif // TASK_HPP
+
+//------------------------------------------------------------------------------
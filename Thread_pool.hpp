@@ -0,0 +1,427 @@
+//------------------------------------------------------------------------------
+
+// Пул потоков с захватом работы (work stealing) для замыканий раздела 6.2,
+// которым перемещены unique_ptr<Widget> или vector<double>
+
+// У каждого рабочего потока своя очередь-дек под собственным мьютексом:
+// поток кладет и берет задачи с хвоста (последняя поставленная еще в
+// кэше), а простаивающие потоки забирают их с головы чужих деков. Общей
+// очереди, общей блокировки и общего счетчика на пути постановки нет -
+// у каждого дека свой счетчик задач, задачи извне раскладываются по
+// декам по кругу, начиная со своего дека для каждого потока, а мьютекс
+// засыпания трогается, только если кто-то действительно спит. Задачи хранятся в Unique_function,
+// поэтому захваченное состояние только перемещается.
+
+// submit() возвращает Task_future с продолжениями then(): продолжение
+// ставится в пул, когда результат готов. get() из рабочего потока не
+// блокирует его, а выполняет чужие задачи, пока результат не готов.
+// Деструктор пула дожидается выполнения всех поставленных задач
+
+//------------------------------------------------------------------------------
+
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+//------------------------------------------------------------------------------
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "Sharded_counter.hpp"
+#include "Unique_function.hpp"
+
+//------------------------------------------------------------------------------
+
+namespace em {
+
+//------------------------------------------------------------------------------
+
+class Thread_pool;
+
+template<class T>
+class Task_future;
+
+namespace pool_detail {
+
+struct Unit {};                         // Значение Task_future<void>
+
+template<class T>
+using Stored = std::conditional_t<std::is_void_v<T>, Unit, T>;
+
+using Callback = Unique_function<void(), 6 * sizeof(void*)>;
+
+template<class T>
+class Shared_state {
+public:
+    explicit Shared_state(Thread_pool* p) noexcept : pool{p} {}
+
+    template<class... Ts>
+    void set_value(Ts&&... params)
+    {
+        std::unique_lock<std::mutex> lock{m};
+        value.emplace(std::forward<Ts>(params)...);
+        complete(lock);
+    }
+
+    void set_error(std::exception_ptr e)
+    {
+        std::unique_lock<std::mutex> lock{m};
+        error = std::move(e);
+        complete(lock);
+    }
+
+    bool ready() const noexcept { return done.load(std::memory_order_acquire); }
+
+    void wait() const
+    {
+        std::unique_lock<std::mutex> lock{m};
+        cv.wait(lock, [this] { return done.load(std::memory_order_relaxed); });
+    }
+
+    // f вызывается сразу, если результат уже готов, иначе - потоком,
+    // который его установит
+    void on_ready(Callback f)
+    {
+        {
+            std::lock_guard<std::mutex> g{m};
+            if (!done.load(std::memory_order_relaxed)) {
+                continuations.push_back(std::move(f));
+                return;
+            }
+        }
+        f();
+    }
+
+    // Только после ready()
+    Stored<T> take()
+    {
+        if (error) std::rethrow_exception(error);
+        return std::move(*value);
+    }
+
+    Thread_pool* const pool;
+private:
+    void complete(std::unique_lock<std::mutex>& lock)
+    {
+        done.store(true, std::memory_order_release);
+        auto fs = std::move(continuations);
+        lock.unlock();
+        cv.notify_all();
+        for (auto& f : fs) f();
+    }
+
+    mutable std::mutex m;
+    mutable std::condition_variable cv;
+    std::atomic<bool> done{false};
+    std::optional<Stored<T>> value;
+    std::exception_ptr error;
+    std::vector<Callback> continuations;
+};
+
+// Вызов f(params...) с записью результата или исключения в state
+template<class T, class F, class... Ts>
+void fulfil(Shared_state<T>& state, F& f, Ts&&... params) noexcept
+{
+    try {
+        if constexpr (std::is_void_v<T>) {
+            std::invoke(f, std::forward<Ts>(params)...);
+            state.set_value();
+        }
+        else {
+            state.set_value(std::invoke(f, std::forward<Ts>(params)...));
+        }
+    }
+    catch (...) {
+        state.set_error(std::current_exception());
+    }
+}
+
+} // namespace pool_detail
+
+//------------------------------------------------------------------------------
+
+class Thread_pool {
+public:
+    using Task = pool_detail::Callback;
+
+    explicit Thread_pool(std::size_t threads = std::thread::hardware_concurrency())
+    {
+        if (!threads) threads = 1;
+        queues.reserve(threads);
+        for (std::size_t i = 0; i < threads; ++i)
+            queues.push_back(std::make_unique<Queue>());
+        workers.reserve(threads);
+        for (std::size_t i = 0; i < threads; ++i)
+            workers.emplace_back([this, i] { run(i); });
+    }
+
+    Thread_pool(const Thread_pool&) = delete;
+    Thread_pool& operator=(const Thread_pool&) = delete;
+
+    ~Thread_pool()
+    {
+        {
+            std::lock_guard<std::mutex> g{sleep_m};
+            stop = true;
+        }
+        sleep_cv.notify_all();
+        for (auto& t : workers) t.join();
+    }
+
+    std::size_t size() const noexcept { return queues.size(); }
+
+    // Поставленные, но еще не начатые задачи (приблизительно)
+    std::size_t pending() const noexcept
+    {
+        std::size_t n = 0;
+        for (const auto& q : queues) n += q->count.load(std::memory_order_relaxed);
+        return n;
+    }
+
+    // Пул, которому принадлежит текущий поток, или nullptr
+    static Thread_pool* current() noexcept { return owner; }
+
+    // Задача без результата; исключение из нее завершает программу,
+    // как и из функции std::thread
+    void post(Task task)
+    {
+        auto& q = *queues[owner == this ? self : external_index()];
+        {
+            std::lock_guard<std::mutex> g{q.m};
+            q.tasks.push_back(std::move(task));
+            q.count.store(q.tasks.size(), std::memory_order_seq_cst);
+        }
+        // После записи счетчика: спящий либо уже учтен в sleepers,
+        // либо увидит задачу при проверке has_work()
+        if (sleepers.load(std::memory_order_seq_cst)) {
+            std::lock_guard<std::mutex> g{sleep_m};
+            sleep_cv.notify_one();
+        }
+    }
+
+    // f(params...) в пуле; аргументы перемещаются в задачу
+    template<class F, class... Ts>
+    auto submit(F&& f, Ts&&... params)
+        -> Task_future<std::invoke_result_t<std::decay_t<F>&, std::decay_t<Ts>...>>;
+
+    // Выполнение одной поставленной задачи в текущем потоке;
+    // false - задач нет
+    bool run_one()
+    {
+        auto home = owner == this ? self : 0;
+        if (auto task = take(home)) {
+            (*task)();
+            return true;
+        }
+        return false;
+    }
+private:
+    struct alignas(64) Queue {
+        std::mutex m;
+        std::deque<Task> tasks;
+        std::atomic<std::size_t> count{0};  // tasks.size() для чтения без m
+    };
+
+    std::optional<Task> pop_back(Queue& q)
+    {
+        if (!q.count.load(std::memory_order_relaxed)) return std::nullopt;
+        std::lock_guard<std::mutex> g{q.m};
+        if (q.tasks.empty()) return std::nullopt;
+        auto task = std::move(q.tasks.back());
+        q.tasks.pop_back();
+        q.count.store(q.tasks.size(), std::memory_order_relaxed);
+        return task;
+    }
+
+    std::optional<Task> pop_front(Queue& q)
+    {
+        if (!q.count.load(std::memory_order_relaxed)) return std::nullopt;
+        std::unique_lock<std::mutex> lock{q.m, std::try_to_lock};
+        if (!lock || q.tasks.empty()) return std::nullopt;
+        auto task = std::move(q.tasks.front());
+        q.tasks.pop_front();
+        q.count.store(q.tasks.size(), std::memory_order_relaxed);
+        return task;
+    }
+
+    // Своя задача с хвоста, иначе чужая с головы
+    std::optional<Task> take(std::size_t home)
+    {
+        auto task = pop_back(*queues[home]);
+        for (std::size_t k = 1; !task && k < size(); ++k)
+            task = pop_front(*queues[(home + k) % size()]);
+        return task;
+    }
+
+    bool has_work() const noexcept
+    {
+        for (const auto& q : queues)
+            if (q->count.load(std::memory_order_seq_cst)) return true;
+        return false;
+    }
+
+    // Дек для задачи извне: у каждого потока свой круговой обход
+    std::size_t external_index() const noexcept
+    {
+        thread_local std::size_t next = thread_shard_seed();
+        return next++ % size();
+    }
+
+    void run(std::size_t i)
+    {
+        owner = this;
+        self = i;
+        for (;;) {
+            if (auto task = take(i)) {
+                (*task)();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock{sleep_m};
+            sleepers.fetch_add(1, std::memory_order_seq_cst);
+            sleep_cv.wait(lock, [this] { return stop || has_work(); });
+            sleepers.fetch_sub(1, std::memory_order_relaxed);
+            if (stop && !has_work()) break;
+        }
+        owner = nullptr;
+    }
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<std::size_t> sleepers{0};   // Пишут только засыпающие
+    std::mutex sleep_m;
+    std::condition_variable sleep_cv;
+    bool stop{false};
+
+    inline static thread_local Thread_pool* owner{nullptr};
+    inline static thread_local std::size_t self{0};
+};
+
+//------------------------------------------------------------------------------
+// Результат задачи пула; как и std::future, только перемещается,
+// а get() и then() забирают результат
+
+template<class T>
+class Task_future {
+public:
+    Task_future() noexcept = default;
+
+    bool valid() const noexcept { return state != nullptr; }
+    bool ready() const { return checked().ready(); }
+
+    // В рабочем потоке того же пула - выполнение других задач
+    void wait() const
+    {
+        auto& s = checked();
+        if (Thread_pool::current() == s.pool) {
+            while (!s.ready())
+                if (!s.pool->run_one()) std::this_thread::yield();
+        }
+        s.wait();
+    }
+
+    T get()
+    {
+        wait();
+        auto s = std::move(state);
+        if constexpr (std::is_void_v<T>) s->take();
+        else return s->take();
+    }
+
+    // Task_future для f(T) (f() для void), выполняемой в пуле после
+    // готовности результата. Исключение пропускает f и передается дальше
+    template<class F>
+    auto then(F&& f)
+    {
+        using R = typename decltype(continuation_result(f))::type;
+        auto s = std::move(checked_state());
+        auto next = std::make_shared<pool_detail::Shared_state<R>>(s->pool);
+        auto* pool = s->pool;
+        s->on_ready([s, next, pool, f = std::forward<F>(f)] () mutable
+        {
+            pool->post([s = std::move(s), next = std::move(next),
+                        f = std::move(f)] () mutable
+            {
+                try {
+                    if constexpr (std::is_void_v<T>) {
+                        s->take();
+                        pool_detail::fulfil(*next, f);
+                    }
+                    else {
+                        pool_detail::fulfil(*next, f, s->take());
+                    }
+                }
+                catch (...) {
+                    next->set_error(std::current_exception());
+                }
+            });
+        });
+        return Task_future<R>{std::move(next)};
+    }
+private:
+    template<class U>
+    friend class Task_future;
+    friend class Thread_pool;
+
+    using State = pool_detail::Shared_state<T>;
+
+    explicit Task_future(std::shared_ptr<State> s) noexcept : state{std::move(s)} {}
+
+    template<class F>
+    static auto continuation_result(F&)
+    {
+        if constexpr (std::is_void_v<T>)
+            return std::type_identity<std::invoke_result_t<F&>>{};
+        else
+            return std::type_identity<std::invoke_result_t<F&, T&&>>{};
+    }
+
+    State& checked() const
+    {
+        if (!state) throw std::future_error{std::future_errc::no_state};
+        return *state;
+    }
+
+    std::shared_ptr<State>& checked_state()
+    {
+        checked();
+        return state;
+    }
+
+    std::shared_ptr<State> state;
+};
+
+//------------------------------------------------------------------------------
+
+template<class F, class... Ts>
+auto Thread_pool::submit(F&& f, Ts&&... params)
+    -> Task_future<std::invoke_result_t<std::decay_t<F>&, std::decay_t<Ts>...>>
+{
+    using R = std::invoke_result_t<std::decay_t<F>&, std::decay_t<Ts>...>;
+    auto state = std::make_shared<pool_detail::Shared_state<R>>(this);
+    post([state, f = std::forward<F>(f),
+          ... params = std::forward<Ts>(params)] () mutable
+    { pool_detail::fulfil(*state, f, std::move(params)...); });
+    return Task_future<R>{std::move(state)};
+}
+
+//------------------------------------------------------------------------------
+
+} // namespace em
+
+//------------------------------------------------------------------------------
+
+#endif // THREAD_POOL_HPP
+
+//------------------------------------------------------------------------------
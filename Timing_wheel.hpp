@@ -0,0 +1,258 @@
+//------------------------------------------------------------------------------
+
+// Иерархическое колесо таймеров (Varghese, Lauck) для set_alarm из 6.4
+
+// Время измеряется целыми тиками. Четыре уровня по 256 ячеек покрывают
+// 2^32 тиков: срок ближе 256 тиков попадает в ячейку нижнего уровня, более
+// далекие - в ячейки верхних, которые при обороте нижнего колеса
+// "осыпаются" (cascade) на уровень ниже. Постановка и отмена - O(1):
+// узлы лежат в одном векторе и связаны в двусвязные списки ячеек
+// индексами, а Handle с номером поколения защищает от отмены уже
+// сработавшего и переиспользованного узла. T должен быть конструируемым
+// по умолчанию и перемещаемым
+
+//------------------------------------------------------------------------------
+
+#ifndef TIMING_WHEEL_HPP
+#define TIMING_WHEEL_HPP
+
+//------------------------------------------------------------------------------
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+//------------------------------------------------------------------------------
+
+namespace em {
+
+//------------------------------------------------------------------------------
+
+template<class T>
+class Timing_wheel {
+public:
+    using Tick = std::uint64_t;
+
+    static constexpr unsigned level_bits = 8;
+    static constexpr unsigned levels = 4;
+    static constexpr std::size_t slots = std::size_t{1} << level_bits;
+    static constexpr Tick horizon = Tick{1} << (level_bits * levels);
+
+    struct Handle {
+        std::uint32_t index{nil};
+        std::uint32_t generation{0};
+    };
+
+    explicit Timing_wheel(Tick start = 0) : current{start}
+    {
+        for (auto& level : heads)
+            for (auto& h : level) h = nil;
+    }
+
+    // Следующий необработанный тик
+    Tick now() const noexcept { return current; }
+    std::size_t size() const noexcept { return count; }
+    bool empty() const noexcept { return count == 0; }
+
+    void reserve(std::size_t n) { nodes.reserve(n); }
+
+    // Срок в прошлом срабатывает на ближайшем тике
+    Handle schedule(Tick expiry, T value)
+    {
+        auto i = allocate();
+        auto& n = nodes[i];
+        n.expiry = expiry < current ? current : expiry;
+        n.value = std::move(value);
+        link(i);
+        ++count;
+        return Handle{i, n.generation};
+    }
+
+    // false, если элемент уже сработал или отменен
+    bool cancel(Handle h) noexcept
+    {
+        if (h.index >= nodes.size()) return false;
+        auto& n = nodes[h.index];
+        if (!n.live || n.generation != h.generation) return false;
+        unlink(h.index);
+        release(h.index);
+        --count;
+        return true;
+    }
+
+    // Тик, раньше которого ничего не сработает и не осыплется;
+    // пусто - элементов нет. advance() перескакивает пустые тики до него
+    std::optional<Tick> next_bound() const noexcept
+    {
+        if (!count) return std::nullopt;
+        auto idx = current & (slots - 1);
+        if (idx == 0) return current;               // Каскад еще впереди
+
+        auto best = ~Tick{0};
+        if (auto j = next_occupied(0, idx); j < slots)
+            best = current - idx + j + (j < idx ? slots : 0);
+        for (unsigned level = 1; level < levels; ++level) {
+            auto base = current >> (level_bits * level);
+            auto cur = base & (slots - 1);
+            auto j = next_occupied(level, (cur + 1) & (slots - 1));
+            if (j == slots) continue;
+            auto steps = ((j - cur - 1) & (slots - 1)) + 1;
+            auto tick = (base + steps) << (level_bits * level);
+            if (tick < best) best = tick;
+        }
+        return best;
+    }
+
+    // Обработка тиков до until включительно: f(Tick expiry, T&&) для
+    // каждого созревшего элемента. Возвращает число срабатываний
+    template<class F>
+    std::size_t advance(Tick until, F f)
+    {
+        std::size_t fired = 0;
+        while (current <= until) {
+            auto bound = next_bound();
+            if (!bound || *bound > until) {         // Пустые тики целиком:
+                current = until + 1;                // до bound нет каскадов
+                break;
+            }
+            current = *bound;
+
+            if ((current & (slots - 1)) == 0) cascade();
+            auto idx = current & (slots - 1);
+            while (heads[0][idx] != nil) {
+                auto i = heads[0][idx];
+                unlink(i);
+                auto expiry = nodes[i].expiry;
+                auto value = std::move(nodes[i].value);
+                release(i);
+                --count;
+                ++fired;
+                f(expiry, std::move(value));
+            }
+            ++current;
+        }
+        return fired;
+    }
+private:
+    static constexpr std::uint32_t nil = ~std::uint32_t{0};
+
+    struct Node {
+        Tick expiry{0};
+        std::uint32_t prev{nil};
+        std::uint32_t next{nil};
+        std::uint32_t generation{0};
+        std::uint16_t level{0};
+        std::uint16_t slot{0};
+        bool live{false};
+        T value{};
+    };
+
+    std::uint32_t allocate()
+    {
+        if (free_head != nil) {
+            auto i = free_head;
+            free_head = nodes[i].next;
+            nodes[i].live = true;
+            return i;
+        }
+        nodes.emplace_back();
+        nodes.back().live = true;
+        return static_cast<std::uint32_t>(nodes.size() - 1);
+    }
+
+    void release(std::uint32_t i) noexcept
+    {
+        auto& n = nodes[i];
+        n.live = false;
+        ++n.generation;
+        n.value = T{};
+        n.next = free_head;
+        free_head = i;
+    }
+
+    // Уровень и ячейка по сроку относительно current
+    void link(std::uint32_t i) noexcept
+    {
+        auto& n = nodes[i];
+        auto expiry = n.expiry;
+        if (expiry - current >= horizon)            // Дальше горизонта -
+            expiry = current + horizon - 1;         // вернемся при каскаде
+        auto delta = expiry - current;
+
+        unsigned level = 0;
+        while (level + 1 < levels && delta >= Tick{1} << (level_bits * (level + 1)))
+            ++level;
+        auto slot = (expiry >> (level_bits * level)) & (slots - 1);
+
+        n.level = static_cast<std::uint16_t>(level);
+        n.slot = static_cast<std::uint16_t>(slot);
+        n.prev = nil;
+        n.next = heads[level][slot];
+        if (n.next != nil) nodes[n.next].prev = i;
+        heads[level][slot] = i;
+        occupied[level][slot / 64] |= std::uint64_t{1} << (slot % 64);
+    }
+
+    void unlink(std::uint32_t i) noexcept
+    {
+        auto& n = nodes[i];
+        if (n.prev != nil) nodes[n.prev].next = n.next;
+        else heads[n.level][n.slot] = n.next;
+        if (n.next != nil) nodes[n.next].prev = n.prev;
+        if (heads[n.level][n.slot] == nil)
+            occupied[n.level][n.slot / 64] &= ~(std::uint64_t{1} << (n.slot % 64));
+    }
+
+    // Первая занятая ячейка уровня level, начиная с from по кругу;
+    // slots - уровень пуст
+    std::size_t next_occupied(unsigned level, std::size_t from) const noexcept
+    {
+        constexpr std::size_t words = slots / 64;
+        for (std::size_t k = 0; k <= words; ++k) {
+            auto w = (from / 64 + k) % words;
+            auto bits = occupied[level][w];
+            if (k == 0) bits &= ~std::uint64_t{0} << (from % 64);
+            else if (k == words) bits &= ~(~std::uint64_t{0} << (from % 64));
+            if (bits) return w * 64 + std::countr_zero(bits);
+        }
+        return slots;
+    }
+
+    // current на границе оборота нижнего колеса: перенос ячеек верхних
+    // уровней вниз, пока индекс уровня нулевой
+    void cascade() noexcept
+    {
+        for (unsigned level = 1; level < levels; ++level) {
+            auto slot = (current >> (level_bits * level)) & (slots - 1);
+            auto i = heads[level][slot];
+            heads[level][slot] = nil;
+            occupied[level][slot / 64] &= ~(std::uint64_t{1} << (slot % 64));
+            while (i != nil) {
+                auto next = nodes[i].next;
+                link(i);
+                i = next;
+            }
+            if (slot != 0) break;
+        }
+    }
+
+    std::vector<Node> nodes;
+    std::uint32_t free_head{nil};
+    std::uint32_t heads[levels][slots];
+    std::uint64_t occupied[levels][slots / 64]{};
+    std::size_t count{0};
+    Tick current;
+};
+
+//------------------------------------------------------------------------------
+
+} // namespace em
+
+//------------------------------------------------------------------------------
+
+#endif // TIMING_WHEEL_HPP
+
+//------------------------------------------------------------------------------
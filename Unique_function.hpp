@@ -0,0 +1,214 @@
+//------------------------------------------------------------------------------
+
+// Unique_function: перемещаемая обертка вызываемых объектов вместо
+// std::function для фильтров Filter_container, bind-объектов и замыканий
+// с инициализирующим захватом из раздела 6.2
+
+// В отличие от std::function, принимает только перемещаемые объекты
+// ([pw = std::move(pw)] с unique_ptr внутри), хранит их в самом объекте,
+// если sizeof не больше Capacity, а выравнивание и перемещение без
+// исключений позволяют, и лишь иначе - в куче. Вызов идет по одному
+// указателю на функцию-переходник, без виртуальной диспетчеризации;
+// тривиально перемещаемые и уничтожаемые объекты переносятся memcpy.
+// Пустая обертка при вызове выбрасывает std::bad_function_call
+
+//------------------------------------------------------------------------------
+
+#ifndef UNIQUE_FUNCTION_HPP
+#define UNIQUE_FUNCTION_HPP
+
+//------------------------------------------------------------------------------
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+//------------------------------------------------------------------------------
+
+namespace em {
+
+//------------------------------------------------------------------------------
+
+template<class Signature, std::size_t Capacity = 4 * sizeof(void*)>
+class Unique_function;
+
+template<class R, class... Args, std::size_t Capacity>
+class Unique_function<R(Args...), Capacity> {
+public:
+    static constexpr std::size_t capacity =
+            Capacity < sizeof(void*) ? sizeof(void*) : Capacity;
+
+    // Поместится ли F без обращения к куче
+    template<class F>
+    static constexpr bool fits_inline =
+            sizeof(F) <= capacity
+            && alignof(F) <= alignof(std::max_align_t)
+            && std::is_nothrow_move_constructible_v<F>;
+
+    Unique_function() noexcept = default;
+    Unique_function(std::nullptr_t) noexcept {}
+
+    template<class F, class D = std::decay_t<F>,
+             class = std::enable_if_t<!std::is_same_v<D, Unique_function>
+                                      && std::is_invocable_r_v<R, D&, Args...>>>
+    Unique_function(F&& f)
+    {
+        if (is_null(f)) return;
+        emplace<D>(std::forward<F>(f));
+    }
+
+    template<class F, class... Ts>
+    explicit Unique_function(std::in_place_type_t<F>, Ts&&... params)
+    { emplace<F>(std::forward<Ts>(params)...); }
+
+    Unique_function(Unique_function&& rhs) noexcept { take(rhs); }
+
+    Unique_function& operator=(Unique_function&& rhs) noexcept
+    {
+        if (this != &rhs) {
+            reset();
+            take(rhs);
+        }
+        return *this;
+    }
+
+    Unique_function& operator=(std::nullptr_t) noexcept
+    {
+        reset();
+        return *this;
+    }
+
+    template<class F, class D = std::decay_t<F>,
+             class = std::enable_if_t<!std::is_same_v<D, Unique_function>
+                                      && std::is_invocable_r_v<R, D&, Args...>>>
+    Unique_function& operator=(F&& f)
+    { return *this = Unique_function{std::forward<F>(f)}; }
+
+    ~Unique_function() { reset(); }
+
+    // Как и std::function, вызывает хранимый объект как неконстантный
+    R operator()(Args... params) const
+    { return invoke(const_cast<std::byte*>(storage), std::forward<Args>(params)...); }
+
+    explicit operator bool() const noexcept { return invoke != &call_empty; }
+
+    // Объект хранится в куче (не поместился в Capacity)
+    bool on_heap() const noexcept { return heap; }
+
+    void swap(Unique_function& rhs) noexcept
+    {
+        Unique_function tmp{std::move(rhs)};
+        rhs = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+    friend void swap(Unique_function& a, Unique_function& b) noexcept { a.swap(b); }
+
+    friend bool operator==(const Unique_function& f, std::nullptr_t) noexcept
+    { return !f; }
+private:
+    using Invoker = R (*)(void*, Args&&...);
+    // Перенос src в dst и уничтожение src; dst == nullptr - только уничтожение
+    using Manager = void (*)(void* dst, void* src) noexcept;
+
+    template<class F>
+    static bool is_null(const F& f) noexcept
+    {
+        if constexpr (std::is_pointer_v<F> || std::is_member_pointer_v<F>)
+            return f == nullptr;
+        else
+            return false;
+    }
+
+    template<class F>
+    static R call(F& f, Args&&... params)
+    {
+        if constexpr (std::is_void_v<R>)
+            std::invoke(f, std::forward<Args>(params)...);
+        else
+            return std::invoke(f, std::forward<Args>(params)...);
+    }
+
+    template<class F>
+    static R call_inline(void* s, Args&&... params)
+    { return call(*std::launder(static_cast<F*>(s)), std::forward<Args>(params)...); }
+
+    template<class F>
+    static R call_heap(void* s, Args&&... params)
+    { return call(**static_cast<F**>(s), std::forward<Args>(params)...); }
+
+    static R call_empty(void*, Args&&...) { throw std::bad_function_call{}; }
+
+    template<class F>
+    static void manage_inline(void* dst, void* src) noexcept
+    {
+        auto* f = std::launder(static_cast<F*>(src));
+        if (dst) ::new (dst) F(std::move(*f));
+        f->~F();
+    }
+
+    template<class F>
+    static void manage_heap(void* dst, void* src) noexcept
+    {
+        if (dst) std::memcpy(dst, src, sizeof(F*));
+        else delete *static_cast<F**>(src);
+    }
+
+    template<class F, class... Ts>
+    void emplace(Ts&&... params)
+    {
+        if constexpr (fits_inline<F>) {
+            ::new (static_cast<void*>(storage)) F(std::forward<Ts>(params)...);
+            invoke = &call_inline<F>;
+            if constexpr (!std::is_trivially_copyable_v<F>
+                          || !std::is_trivially_destructible_v<F>)
+                manage = &manage_inline<F>;
+        }
+        else {
+            auto* p = new F(std::forward<Ts>(params)...);
+            std::memcpy(storage, &p, sizeof p);
+            invoke = &call_heap<F>;
+            manage = &manage_heap<F>;
+            heap = true;
+        }
+    }
+
+    // Перенос из rhs в пустой *this; rhs становится пустым
+    void take(Unique_function& rhs) noexcept
+    {
+        if (rhs.manage) rhs.manage(storage, rhs.storage);
+        else std::memcpy(storage, rhs.storage, capacity);
+        invoke = rhs.invoke;
+        manage = rhs.manage;
+        heap = rhs.heap;
+        rhs.invoke = &call_empty;
+        rhs.manage = nullptr;
+        rhs.heap = false;
+    }
+
+    void reset() noexcept
+    {
+        if (manage) manage(nullptr, storage);
+        invoke = &call_empty;
+        manage = nullptr;
+        heap = false;
+    }
+
+    alignas(std::max_align_t) std::byte storage[capacity];
+    Invoker invoke{&call_empty};
+    Manager manage{nullptr};            // nullptr - перенос memcpy
+    bool heap{false};
+};
+
+//------------------------------------------------------------------------------
+
+} // namespace em
+
+//------------------------------------------------------------------------------
+
+#endif // UNIQUE_FUNCTION_HPP
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,239 @@
+//------------------------------------------------------------------------------
+
+// Потокобезопасный кэш для fast_load_widget из раздела 4.3
+
+// Как и в книге, кэш хранит std::weak_ptr и не продлевает жизнь объектов.
+// Отличия: карта разбита на шарды по хешу ключа, у каждого свой мьютекс;
+// просроченные weak_ptr вычищаются понемногу при каждой вставке, так что
+// карта не растет бесконечно; необязательный "горячий" уровень держит
+// сильные ссылки на N последних использованных объектов (LRU), чтобы они
+// не выгружались между обращениями
+
+//------------------------------------------------------------------------------
+
+#ifndef WEAK_CACHE_HPP
+#define WEAK_CACHE_HPP
+
+//------------------------------------------------------------------------------
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "Sharded_counter.hpp"
+
+//------------------------------------------------------------------------------
+
+namespace em {
+
+//------------------------------------------------------------------------------
+
+struct Weak_cache_options {
+    std::size_t shards{16};             // Степень двойки
+    std::size_t hot_capacity{0};        // Сильных ссылок на весь кэш; 0 - нет
+    std::size_t sweep_buckets{2};       // Корзин, проверяемых за вставку
+};
+
+struct Weak_cache_metrics {
+    std::uint64_t hits{0};
+    std::uint64_t misses{0};
+    std::uint64_t swept{0};             // Удалено просроченных записей
+    std::size_t size{0};                // Записей в картах
+    std::size_t hot_size{0};            // Объектов в горячем уровне
+};
+
+//------------------------------------------------------------------------------
+
+template<class Key, class Value, class Hash = std::hash<Key>>
+class Weak_cache {
+public:
+    using Pointer = std::shared_ptr<const Value>;
+
+    explicit Weak_cache(Weak_cache_options o = {})
+        : opts{o}, shards(round_up_pow2(o.shards))
+    {
+        auto per_shard = (o.hot_capacity + shards.size() - 1) / shards.size();
+        for (auto& s : shards) s.hot_capacity = per_shard;
+    }
+
+    Weak_cache(const Weak_cache&) = delete;
+    Weak_cache& operator=(const Weak_cache&) = delete;
+
+    // Объект из кэша или результат load(id). load вызывается без
+    // блокировки шарда; при одновременном промахе по одному ключу
+    // загрузка может выполниться дважды, в кэше останется первая
+    template<class Loader>
+    Pointer get(const Key& id, Loader&& load)
+    {
+        auto& s = shard_for(id);
+        {
+            std::lock_guard<std::mutex> g{s.m};
+            if (auto obj_ptr = s.lookup(id)) {
+                hit_count.add();
+                return obj_ptr;
+            }
+        }
+        miss_count.add();
+
+        Pointer obj_ptr{std::forward<Loader>(load)(id)};
+        if (!obj_ptr) return obj_ptr;
+
+        std::lock_guard<std::mutex> g{s.m};
+        if (auto existing = s.lookup(id)) return existing;
+        s.insert(id, obj_ptr);
+        swept_count.add(s.sweep(opts.sweep_buckets));
+        return obj_ptr;
+    }
+
+    // Объект из кэша без загрузки; nullptr при отсутствии
+    Pointer find(const Key& id)
+    {
+        auto& s = shard_for(id);
+        std::lock_guard<std::mutex> g{s.m};
+        return s.lookup(id);
+    }
+
+    void erase(const Key& id)
+    {
+        auto& s = shard_for(id);
+        std::lock_guard<std::mutex> g{s.m};
+        s.erase(id);
+    }
+
+    // Полная чистка просроченных записей (например, по таймеру)
+    std::size_t sweep_all()
+    {
+        std::size_t n = 0;
+        for (auto& s : shards) {
+            std::lock_guard<std::mutex> g{s.m};
+            n += s.sweep(s.map.bucket_count());
+        }
+        swept_count.add(n);
+        return n;
+    }
+
+    Weak_cache_metrics metrics() const
+    {
+        Weak_cache_metrics mt;
+        mt.hits = hit_count.load();
+        mt.misses = miss_count.load();
+        mt.swept = swept_count.load();
+        for (auto& s : shards) {
+            std::lock_guard<std::mutex> g{s.m};
+            mt.size += s.map.size();
+            mt.hot_size += s.hot.size();
+        }
+        return mt;
+    }
+private:
+    using Hot_list = std::list<std::pair<Key, Pointer>>;
+
+    struct Entry {
+        std::weak_ptr<const Value> weak;
+        typename Hot_list::iterator hot_pos;
+        bool is_hot{false};
+    };
+
+    struct alignas(cache_line_size) Shard {
+        mutable std::mutex m;
+        std::unordered_map<Key, Entry, Hash> map;
+        Hot_list hot;                   // Голова - последний использованный
+        std::size_t hot_capacity{0};
+        std::size_t sweep_cursor{0};
+
+        Pointer lookup(const Key& id)
+        {
+            auto it = map.find(id);
+            if (it == map.end()) return nullptr;
+            auto& e = it->second;
+            if (e.is_hot) {
+                hot.splice(hot.begin(), hot, e.hot_pos);
+                return e.hot_pos->second;
+            }
+            auto obj_ptr = e.weak.lock();
+            if (obj_ptr) make_hot(id, e, obj_ptr);
+            return obj_ptr;
+        }
+
+        void insert(const Key& id, const Pointer& obj_ptr)
+        {
+            auto& e = map[id];
+            e.weak = obj_ptr;
+            make_hot(id, e, obj_ptr);
+        }
+
+        void erase(const Key& id)
+        {
+            auto it = map.find(id);
+            if (it == map.end()) return;
+            if (it->second.is_hot) hot.erase(it->second.hot_pos);
+            map.erase(it);
+        }
+
+        void make_hot(const Key& id, Entry& e, const Pointer& obj_ptr)
+        {
+            if (!hot_capacity || e.is_hot) return;
+            hot.emplace_front(id, obj_ptr);
+            e.hot_pos = hot.begin();
+            e.is_hot = true;
+            if (hot.size() > hot_capacity) {    // Вытеснение: остается weak
+                map[hot.back().first].is_hot = false;
+                hot.pop_back();
+            }
+        }
+
+        // Проверка buckets корзин, начиная с курсора; возвращает
+        // число удаленных просроченных записей
+        std::size_t sweep(std::size_t buckets)
+        {
+            auto count = map.bucket_count();
+            if (!count) return 0;
+            buckets = buckets < count ? buckets : count;
+
+            std::vector<Key> expired;
+            for (std::size_t i = 0; i < buckets; ++i) {
+                auto b = sweep_cursor++ % count;
+                for (auto it = map.begin(b); it != map.end(b); ++it)
+                    if (!it->second.is_hot && it->second.weak.expired())
+                        expired.push_back(it->first);
+            }
+            for (const auto& k : expired) map.erase(k);
+            return expired.size();
+        }
+    };
+
+    static std::size_t round_up_pow2(std::size_t n)
+    {
+        std::size_t p = 1;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    Shard& shard_for(const Key& id)
+    {
+        // Старшие биты перемешанного хеша: младшие нужны unordered_map
+        auto h = Hash{}(id) * 0x9E3779B97F4A7C15ull;
+        return shards[(h >> 32) & (shards.size() - 1)];
+    }
+
+    Weak_cache_options opts;
+    std::vector<Shard> shards;
+    Sharded_counter<std::uint64_t, 16> hit_count;
+    Sharded_counter<std::uint64_t, 16> miss_count;
+    Sharded_counter<std::uint64_t, 4> swept_count;
+};
+
+//------------------------------------------------------------------------------
+
+} // namespace em
+
+//------------------------------------------------------------------------------
+
+#endif // WEAK_CACHE_HPP
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,86 @@
+//------------------------------------------------------------------------------
+
+// Точка входа для микробенчмарков (цель bench в em_cpp.pro)
+// bench [--filter=подстрока] [--format=text|csv|json]
+//       [--samples=N] [--min-time-ms=N] [--out=файл]
+
+//------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "Benchmark.hpp"
+
+// Единственное место, где заменяются глобальные operator new/delete
+#define EM_ALLOC_COUNTER_IMPLEMENTATION
+#include "Alloc_counter.hpp"
+
+//------------------------------------------------------------------------------
+
+namespace {
+
+// Накладные расходы самого цикла замера; служат нулевой точкой
+em::Bench_registrar baseline_suite{"baseline", [] (em::Bench_session& s)
+{
+    s.run("baseline/empty", [] { em::clobber_memory(); });
+    double x{3.0}, y{4.0};
+    s.run("baseline/hypot", [&] {
+        em::do_not_optimize(x);
+        return std::hypot(x, y);
+    });
+}};
+
+bool starts_with(const std::string& arg, const std::string& prefix)
+{ return arg.compare(0, prefix.size(), prefix) == 0; }
+
+} // namespace
+
+//------------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    em::Bench_options opts;
+    em::Report_format format{em::Report_format::text};
+    std::string filter;
+    std::string out_path;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg{argv[i]};
+        auto value = arg.substr(arg.find('=') + 1);
+        if (starts_with(arg, "--filter="))
+            filter = value;
+        else if (starts_with(arg, "--format=")) {
+            if (value == "csv")       format = em::Report_format::csv;
+            else if (value == "json") format = em::Report_format::json;
+            else                      format = em::Report_format::text;
+        }
+        else if (starts_with(arg, "--samples="))
+            opts.samples = std::max(1, std::atoi(value.c_str()));
+        else if (starts_with(arg, "--min-time-ms="))
+            opts.min_sample_time = std::chrono::milliseconds(
+                        std::max(1, std::atoi(value.c_str())));
+        else if (starts_with(arg, "--out="))
+            out_path = value;
+        else {
+            std::cerr << "Неизвестный аргумент: " << arg << '\n';
+            return EXIT_FAILURE;
+        }
+    }
+
+    em::Bench_session session{opts, filter};
+    for (auto& [name, suite] : em::bench_suites())
+        suite(session);
+
+    if (out_path.empty())
+        em::report(std::cout, session.all(), format);
+    else {
+        std::ofstream ofs{out_path};
+        em::report(ofs, session.all(), format);
+    }
+    return EXIT_SUCCESS;
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,282 @@
+//------------------------------------------------------------------------------
+
+// Бенчмарки к разделу 6.4: set_alarm на Timing_wheel против
+// std::priority_queue - стоимость постановки/отмены и точность срабатывания
+
+//------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <latch>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+#include "Alarm_service.hpp"
+#include "Benchmark.hpp"
+
+//------------------------------------------------------------------------------
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using em::Alarm;
+using em::Sound;
+using em::Volume;
+
+//------------------------------------------------------------------------------
+// Очередь с приоритетом: постановка O(log n), отмена - ленивая пометка
+
+class Pq_timers {
+public:
+    using Tick = std::uint64_t;
+
+    std::uint64_t schedule(Tick expiry, Alarm a)
+    {
+        auto id = next_id++;
+        q.push(Entry{expiry, id, a});
+        return id;
+    }
+
+    bool cancel(std::uint64_t id) { return cancelled.insert(id).second; }
+
+    bool empty() const { return q.empty(); }
+    Tick top() const { return q.top().expiry; }
+
+    template<class F>
+    void advance(Tick until, F f)
+    {
+        while (!q.empty() && q.top().expiry <= until) {
+            auto e = q.top();
+            q.pop();
+            if (cancelled.erase(e.id)) continue;
+            f(e.expiry, std::move(e.alarm));
+        }
+    }
+private:
+    struct Entry {
+        Tick expiry;
+        std::uint64_t id;
+        Alarm alarm;
+
+        bool operator<(const Entry& rhs) const { return expiry > rhs.expiry; }
+    };
+
+    std::priority_queue<Entry> q;
+    std::unordered_set<std::uint64_t> cancelled;
+    std::uint64_t next_id{0};
+};
+
+// Та же служба, что em::Alarm_service, но на Pq_timers
+class Pq_alarm_service {
+public:
+    using Handler = em::Alarm_service::Handler;
+
+    explicit Pq_alarm_service(Handler h)
+        : handler{std::move(h)}, epoch{Clock::now()}, worker{[this] { run(); }} {}
+
+    ~Pq_alarm_service()
+    {
+        {
+            std::lock_guard<std::mutex> g{m};
+            stop = true;
+        }
+        cv.notify_one();
+        worker.join();
+    }
+
+    void set_alarm(Clock::time_point t, Sound s, Clock::duration d,
+                   Volume v = Volume::Normal)
+    {
+        std::lock_guard<std::mutex> g{m};
+        bool first = timers.empty() || ticks(t) < timers.top();
+        timers.schedule(ticks(t), Alarm{t, s, d, v});
+        if (first) cv.notify_one();
+    }
+private:
+    std::uint64_t ticks(Clock::time_point t) const
+    { return std::uint64_t((t - epoch).count()); }
+
+    void run()
+    {
+        std::vector<Alarm> batch;
+        std::unique_lock<std::mutex> lock{m};
+        while (!stop) {
+            batch.clear();
+            timers.advance(ticks(Clock::now()), [&batch] (auto, Alarm&& a)
+            { batch.push_back(std::move(a)); });
+            if (!batch.empty()) {
+                lock.unlock();
+                handler(std::span<const Alarm>{batch});
+                lock.lock();
+                continue;
+            }
+            if (timers.empty()) cv.wait(lock);
+            else cv.wait_until(lock, epoch + Clock::duration{timers.top()});
+        }
+    }
+
+    Handler handler;
+    Clock::time_point epoch;
+    std::mutex m;
+    std::condition_variable cv;
+    Pq_timers timers;
+    bool stop{false};
+    std::thread worker;
+};
+
+//------------------------------------------------------------------------------
+// Постановка и отмена при большом числе ожидающих будильников
+
+constexpr std::size_t preloaded = 1 << 20;
+constexpr std::size_t ops_per_run = 1 << 12;
+
+std::vector<std::uint64_t> make_expiries(std::size_t n)
+{
+    std::mt19937_64 gen{42};
+    std::vector<std::uint64_t> v(n);
+    for (auto& x : v) x = gen() % 3'600'000;       // Час при тике 1 мс
+    return v;
+}
+
+void arm_cancel_suite(em::Bench_session& s)
+{
+    auto expiries = make_expiries(preloaded + ops_per_run);
+    const Alarm a{Clock::now(), Sound::Beep, std::chrono::seconds{30}};
+
+    {
+        em::Timing_wheel<Alarm> wheel;
+        wheel.reserve(preloaded + ops_per_run);
+        for (std::size_t i = 0; i < preloaded; ++i) wheel.schedule(expiries[i], a);
+
+        std::vector<em::Timing_wheel<Alarm>::Handle> ids(ops_per_run);
+        if (auto* r = s.run("6.4/alarm/arm_cancel/wheel", [&]
+            {
+                for (std::size_t i = 0; i < ops_per_run; ++i)
+                    ids[i] = wheel.schedule(expiries[preloaded + i], a);
+                for (auto id : ids) wheel.cancel(id);
+            })) {
+            r->counter("ns/op", r->median.count() / (2 * ops_per_run));
+            r->counter("pending", preloaded);
+        }
+    }
+    {
+        Pq_timers timers;
+        for (std::size_t i = 0; i < preloaded; ++i) timers.schedule(expiries[i], a);
+
+        // Отмененные остаются в куче до своего срока: продвигаем
+        // "время" за каждый прогон, чтобы куча не росла бесконечно
+        std::vector<std::uint64_t> ids(ops_per_run);
+        std::uint64_t now = 0;
+        if (auto* r = s.run("6.4/alarm/arm_cancel/priority_queue", [&]
+            {
+                for (std::size_t i = 0; i < ops_per_run; ++i)
+                    ids[i] = timers.schedule(now + expiries[preloaded + i] % 64, a);
+                for (auto id : ids) timers.cancel(id);
+                now += 64;
+                timers.advance(now, [] (auto, Alarm&&) {});
+            })) {
+            r->counter("ns/op", r->median.count() / (2 * ops_per_run));
+            r->counter("pending", preloaded);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+// Опоздание срабатывания: пачка будильников в ближайшие 20 мс
+
+constexpr int alarms_per_run = 64;
+
+struct Jitter_probe {
+    std::vector<double> late_us;
+    std::latch* done{nullptr};
+    std::mutex m;
+
+    void operator()(std::span<const Alarm> batch)
+    {
+        auto now = Clock::now();
+        std::lock_guard<std::mutex> g{m};
+        for (const auto& a : batch) {
+            late_us.push_back(std::chrono::duration<double, std::micro>(
+                                  now - a.t).count());
+            done->count_down();
+        }
+    }
+
+    void report(em::Bench_result* r)
+    {
+        if (!r || late_us.empty()) return;
+        std::sort(late_us.begin(), late_us.end());
+        auto at = [this] (double q)
+        { return late_us[std::size_t(q * (late_us.size() - 1))]; };
+        r->counter("late_p50_us", at(0.5));
+        r->counter("late_p99_us", at(0.99));
+        r->counter("late_max_us", late_us.back());
+        r->counter("early", std::count_if(late_us.begin(), late_us.end(),
+                                          [] (double x) { return x < 0; }));
+    }
+};
+
+template<class Service>
+em::Bench_result* run_jitter(em::Bench_session& s, const std::string& name,
+                             Jitter_probe& probe, Service& service)
+{
+    std::mt19937 gen{7};
+    std::uniform_int_distribution<int> offset_us{1000, 20000};
+    auto* r = s.run(name, [&]
+    {
+        std::latch done{alarms_per_run};
+        {
+            std::lock_guard<std::mutex> g{probe.m};
+            probe.done = &done;
+        }
+        auto now = Clock::now();
+        for (int i = 0; i < alarms_per_run; ++i)
+            service.set_alarm(now + std::chrono::microseconds{offset_us(gen)},
+                              Sound::Beep, std::chrono::seconds{30},
+                              Volume::Loud);
+        done.wait();
+    });
+    probe.report(r);
+    return r;
+}
+
+void jitter_suite(em::Bench_session& s)
+{
+    {
+        Jitter_probe probe;
+        em::Alarm_service service{std::ref(probe)};
+        if (auto* r = run_jitter(s, "6.4/alarm/jitter/wheel", probe, service))
+            r->counter("batches", service.batches());
+    }
+    {
+        Jitter_probe probe;
+        em::Alarm_service service{std::ref(probe),
+                                  {std::chrono::milliseconds{1},
+                                   std::chrono::milliseconds{2}}};
+        if (auto* r = run_jitter(s, "6.4/alarm/jitter/wheel_slack_2ms",
+                                 probe, service))
+            r->counter("batches", service.batches());
+    }
+    {
+        Jitter_probe probe;
+        Pq_alarm_service service{std::ref(probe)};
+        run_jitter(s, "6.4/alarm/jitter/priority_queue", probe, service);
+    }
+}
+
+em::Bench_registrar alarm_suite{"6.4/alarm", [] (em::Bench_session& s)
+{
+    arm_cancel_suite(s);
+    jitter_suite(s);
+}};
+
+} // namespace
+
+//------------------------------------------------------------------------------
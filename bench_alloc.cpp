@@ -0,0 +1,119 @@
+//------------------------------------------------------------------------------
+
+// Бенчмарки к разделам 4.4 и 5.x: аллокации make_shared против new,
+// перемещения против копирования
+
+//------------------------------------------------------------------------------
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Alloc_counter.hpp"
+#include "Benchmark.hpp"
+
+//------------------------------------------------------------------------------
+
+namespace {
+
+struct Widget {
+    int payload[8]{};
+};
+
+//------------------------------------------------------------------------------
+// Замер op со счетчиками одного дополнительного прогона.
+// expected_allocs < 0 - ожидание не задано; иначе расхождение
+// с фактическим числом аллокаций выводится в std::cerr
+
+template<class Op>
+void run_counted(em::Bench_session& s, std::string name, Op op,
+                 long expected_allocs = -1)
+{
+    auto* r = s.run(name, op);
+    if (!r) return;
+
+    em::Alloc_stats st;
+    {
+        em::Alloc_scope scope;
+        op();
+        st = scope.stats();
+    }
+    r->counter("allocs/op", st.allocations);
+    r->counter("bytes/op", st.bytes_allocated);
+    r->counter("peak_bytes", st.peak_live_bytes);
+
+    if (expected_allocs >= 0
+        && st.allocations != static_cast<std::size_t>(expected_allocs))
+        std::cerr << name << ": ожидалось " << expected_allocs
+                  << " аллокаций, получено " << st.allocations << '\n';
+}
+
+//------------------------------------------------------------------------------
+// 4.4: make_shared выделяет объект и управляющий блок одним блоком
+
+void make_shared_suite(em::Bench_session& s)
+{
+    run_counted(s, "4.4/make_shared<Widget>()", []
+    {
+        auto spw(std::make_shared<Widget>());
+        em::do_not_optimize(spw);
+    }, 1);
+    run_counted(s, "4.4/shared_ptr<Widget>(new Widget)", []
+    {
+        std::shared_ptr<Widget> spw(new Widget);
+        em::do_not_optimize(spw);
+    }, 2);
+    run_counted(s, "4.4/make_unique<Widget>()", []
+    {
+        auto upw(std::make_unique<Widget>());
+        em::do_not_optimize(upw);
+    }, 1);
+}
+
+//------------------------------------------------------------------------------
+// Глава 5: перемещение не выделяет память, копирование - выделяет
+
+void move_suite(em::Bench_session& s)
+{
+    std::string long_str(64, 'x');
+    run_counted(s, "5/string/copy", [&long_str]
+    {
+        std::string copy{long_str};
+        em::do_not_optimize(copy);
+    }, 1);
+    run_counted(s, "5/string/move", [&long_str]
+    {
+        std::string moved{std::move(long_str)};
+        em::do_not_optimize(moved);
+        long_str = std::move(moved);            // Возврат без аллокаций
+    }, 0);
+
+    std::vector<double> data(1024, 1.0);
+    run_counted(s, "5/vector<double>/copy", [&data]
+    {
+        std::vector<double> copy{data};
+        em::do_not_optimize(copy);
+    }, 1);
+    run_counted(s, "5/vector<double>/move", [&data]
+    {
+        std::vector<double> moved{std::move(data)};
+        em::do_not_optimize(moved);
+        data = std::move(moved);
+    }, 0);
+}
+
+//------------------------------------------------------------------------------
+
+em::Bench_registrar alloc_suite{"alloc", [] (em::Bench_session& s)
+{
+    if (!em::alloc_counter_installed) {
+        std::cerr << "alloc: счетчик аллокаций не установлен\n";
+        return;
+    }
+    make_shared_suite(s);
+    move_suite(s);
+}};
+
+} // namespace
+
+//------------------------------------------------------------------------------
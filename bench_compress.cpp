@@ -0,0 +1,143 @@
+//------------------------------------------------------------------------------
+
+// Бенчмарки к разделу 6.4: compress(const Widget&, Comp_level) - один поток
+// против фрагментов на всех ядрах, скорость и степень сжатия по уровням
+
+//------------------------------------------------------------------------------
+
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "Benchmark.hpp"
+#include "Compression.hpp"
+
+//------------------------------------------------------------------------------
+
+namespace {
+
+// Виджет "как в архиве": имена, идентификаторы и замеры
+struct Widget {
+    std::vector<std::string> names;
+    std::vector<std::uint32_t> ids;
+    std::vector<double> samples;
+};
+
+template<class Out>
+void serialize(const Widget& w, Out& out)
+{
+    out.write_value(std::uint64_t(w.names.size()));
+    for (const auto& n : w.names) {
+        out.write_value(std::uint32_t(n.size()));
+        out.write(n.data(), n.size());
+    }
+    out.write_value(std::uint64_t(w.ids.size()));
+    out.write(w.ids.data(), w.ids.size() * sizeof(std::uint32_t));
+    out.write_value(std::uint64_t(w.samples.size()));
+    out.write(w.samples.data(), w.samples.size() * sizeof(double));
+}
+
+Widget make_widget()
+{
+    static const char* const words[]{"alpha", "beta", "gamma", "delta",
+                                     "widget", "sensor", "north", "south",
+                                     "pressure", "temperature", "valve"};
+    std::mt19937_64 gen{42};
+    Widget w;
+    for (int i = 0; i < 200'000; ++i) {
+        std::string n;
+        for (int k = 0, m = 2 + int(gen() % 3); k < m; ++k) {
+            if (k) n += '_';
+            n += words[gen() % std::size(words)];
+        }
+        n += std::to_string(gen() % 10'000);
+        w.names.push_back(std::move(n));
+    }
+    std::uint32_t id = 1'000'000;
+    for (int i = 0; i < 500'000; ++i) w.ids.push_back(id += 1 + gen() % 8);
+    double x = 20.0;
+    for (int i = 0; i < 500'000; ++i) {
+        x += (int(gen() % 21) - 10) * 0.125;                // Квантованный шум
+        w.samples.push_back(x);
+    }
+    return w;
+}
+
+// Сериализованный виджет без сжатия - эталон для проверки распаковки
+struct Byte_writer {
+    std::vector<std::byte> bytes;
+
+    void write(const void* p, std::size_t n)
+    {
+        auto* b = static_cast<const std::byte*>(p);
+        bytes.insert(bytes.end(), b, b + n);
+    }
+
+    template<class T>
+    void write_value(const T& value) { write(&value, sizeof value); }
+};
+
+const char* name_of(em::Comp_level level)
+{
+    switch (level) {
+    case em::Comp_level::low:    return "low";
+    case em::Comp_level::high:   return "high";
+    default:                     return "normal";
+    }
+}
+
+void run_level(em::Bench_session& s, const Widget& w,
+               const std::vector<std::byte>& raw, em::Comp_level level)
+{
+    for (std::size_t threads : {std::size_t{1}, std::size_t{0}}) {
+        em::Compress_options o;
+        o.level = level;
+        o.threads = threads;
+        auto name = std::string{"6.4/compress/"} + name_of(level)
+                    + (threads == 1 ? "/serial" : "/parallel");
+
+        std::uint64_t in = 0;
+        std::uint64_t out = 0;
+        auto* r = s.run(name, [&]
+        {
+            em::Compress_stream stream{[] (std::span<const std::byte> b)
+                                       { em::do_not_optimize(b); }, o};
+            serialize(w, stream);
+            stream.finish();
+            in = stream.bytes_in();
+            out = stream.bytes_out();
+        });
+        if (!r) continue;
+        r->counter("MB/s", in * 1e3 / r->median.count());
+        r->counter("ratio", double(in) / double(out));
+    }
+
+    auto packed = em::compress(w, level);
+    if (em::decompress(packed) != raw)
+        std::cerr << "6.4/compress/" << name_of(level)
+                  << ": распаковка не совпала с исходными данными\n";
+
+    if (auto* r = s.run(std::string{"6.4/compress/"} + name_of(level) + "/decompress",
+        [&]
+        {
+            em::Decompress_stream stream{[] (std::span<const std::byte> b)
+                                         { em::do_not_optimize(b); }};
+            stream.write(packed);
+        }))
+        r->counter("MB/s", raw.size() * 1e3 / r->median.count());
+}
+
+em::Bench_registrar compress_suite{"6.4/compress", [] (em::Bench_session& s)
+{
+    auto w = make_widget();
+    Byte_writer raw;
+    serialize(w, raw);
+    for (auto level : {em::Comp_level::low, em::Comp_level::normal,
+                       em::Comp_level::high})
+        run_level(s, w, raw.bytes, level);
+}};
+
+} // namespace
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,153 @@
+//------------------------------------------------------------------------------
+
+// Бенчмарки к разделу 6.4: сопрограммы em::Task на em::Event_loop -
+// тысячи одновременно спящих задач против потока на операцию,
+// переключение и вызов задачи с кадром из Slab_pool
+
+//------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Alloc_counter.hpp"
+#include "Benchmark.hpp"
+#include "Event_loop.hpp"
+
+//------------------------------------------------------------------------------
+
+namespace {
+
+using namespace std::chrono;
+
+//------------------------------------------------------------------------------
+// Одновременно ожидающие операции: каждая спит 1-10 мс
+
+constexpr auto max_sleep = milliseconds{10};
+
+std::vector<milliseconds> make_sleeps(std::size_t n)
+{
+    std::mt19937 gen{42};
+    std::vector<milliseconds> v(n);
+    for (auto& d : v) d = milliseconds{1 + gen() % max_sleep.count()};
+    return v;
+}
+
+em::Task<void> sleeper(em::Event_loop& loop, milliseconds d, std::atomic<int>& early)
+{
+    auto t = steady_clock::now() + d;
+    co_await loop.sleep_until(t);
+    if (steady_clock::now() < t) ++early;
+}
+
+// Сверх самого долгого сна, на одну операцию
+void add_overhead(em::Bench_result* r, std::size_t ops)
+{
+    if (!r) return;
+    auto extra = r->median.count() - double(nanoseconds{max_sleep}.count());
+    r->counter("overhead_ns/op", std::max(0.0, extra) / ops);
+}
+
+void sleepers_suite(em::Bench_session& s)
+{
+    for (std::size_t n : {1'000, 10'000}) {
+        auto sleeps = make_sleeps(n);
+        std::atomic<int> early{0};
+        em::Event_loop loop;
+        auto name = "6.4/coro/sleepers/event_loop/" + std::to_string(n);
+        if (auto* r = s.run(name, [&]
+            {
+                for (auto d : sleeps) loop.spawn(sleeper(loop, d, early));
+                loop.run();
+            })) {
+            add_overhead(r, n);
+            r->counter("early", early.load());
+        }
+    }
+
+    // Поток на операцию: на 10'000 потоков уже не хватает ресурсов
+    constexpr std::size_t n = 1'000;
+    auto sleeps = make_sleeps(n);
+    add_overhead(s.run("6.4/coro/sleepers/thread_per_op/1000", [&]
+    {
+        std::vector<std::thread> threads;
+        threads.reserve(n);
+        for (auto d : sleeps) threads.emplace_back([d] { std::this_thread::sleep_for(d); });
+        for (auto& t : threads) t.join();
+    }), n);
+}
+
+//------------------------------------------------------------------------------
+// Переключение через очередь цикла
+
+constexpr int yielders = 100;
+constexpr int yields_per_task = 1000;
+
+em::Task<void> yielder(em::Event_loop& loop, long& count)
+{
+    for (int i = 0; i < yields_per_task; ++i) {
+        co_await loop.schedule();
+        ++count;
+    }
+}
+
+void yield_suite(em::Bench_session& s)
+{
+    em::Event_loop loop;
+    long count = 0;
+    if (auto* r = s.run("6.4/coro/yield", [&]
+        {
+            for (int i = 0; i < yielders; ++i) loop.spawn(yielder(loop, count));
+            loop.run();
+        }))
+        r->counter("ns/switch", r->median.count() / double(yielders * yields_per_task));
+}
+
+//------------------------------------------------------------------------------
+// co_await вложенной задачи: кадр из Slab_pool, передача управления
+// без участия цикла
+
+constexpr int calls_per_run = 100'000;
+
+em::Task<int> add(int a, int b) { co_return a + b; }
+
+em::Task<long> sum_calls()
+{
+    long sum = 0;
+    for (int i = 0; i < calls_per_run; ++i) sum += co_await add(i, 1);
+    co_return sum;
+}
+
+void call_suite(em::Bench_session& s)
+{
+    em::Event_loop loop;
+    long sum = 0;
+    auto* r = s.run("6.4/coro/task_call", [&] { sum = loop.run(sum_calls()); });
+    if (!r) return;
+
+    std::size_t allocs;
+    {
+        em::Alloc_scope scope;
+        sum = loop.run(sum_calls());
+        allocs = scope.allocations();
+    }
+    r->counter("ns/call", r->median.count() / double(calls_per_run));
+    r->counter("mallocs/call", double(allocs) / calls_per_run);
+    if (sum != long(calls_per_run) * (calls_per_run + 1) / 2)
+        std::cerr << "6.4/coro/task_call: неверная сумма " << sum << '\n';
+}
+
+em::Bench_registrar coro_suite{"6.4/coro", [] (em::Bench_session& s)
+{
+    sleepers_suite(s);
+    yield_suite(s);
+    call_suite(s);
+}};
+
+} // namespace
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,77 @@
+//------------------------------------------------------------------------------
+
+// Бенчмарки к разделу 3.10: Point::distance_from_origin со счетчиком
+// вызовов в общем std::atomic и в Sharded_counter
+
+//------------------------------------------------------------------------------
+
+#include <atomic>
+#include <cmath>
+#include <string>
+#include <thread>
+#include "Benchmark.hpp"
+#include "Sharded_counter.hpp"
+
+//------------------------------------------------------------------------------
+
+namespace {
+
+class Atomic_point {                // Версия из книги, но со счетчиком
+public:                             // для всех точек, как в статистике
+    Atomic_point(double xx, double yy) : x{xx}, y{yy} {}
+
+    double distance_from_origin() const noexcept
+    {
+        call_count.fetch_add(1, std::memory_order_relaxed);
+        return std::hypot(x, y);
+    }
+
+    inline static std::atomic<unsigned long> call_count{0};
+private:
+    double x, y;
+};
+
+class Point {
+public:
+    Point(double xx, double yy) : x{xx}, y{yy} {}
+
+    double distance_from_origin() const noexcept
+    {
+        ++call_count;               // Инкремент своего шарда
+        return std::hypot(x, y);
+    }
+
+    inline static em::Sharded_counter<unsigned long> call_count;
+private:
+    double x, y;
+};
+
+em::Bench_registrar counter_suite{"counter", [] (em::Bench_session& s)
+{
+    int hw = static_cast<int>(std::thread::hardware_concurrency());
+    int max_threads = hw > 1 ? hw : 2;
+
+    for (int t = 1; t <= max_threads; t *= 2) {
+        auto suffix = "/threads:" + std::to_string(t);
+
+        std::atomic<unsigned long> plain{0};
+        s.run_threaded("3.10/counter/atomic" + suffix, t, [&plain] (std::size_t)
+        { plain.fetch_add(1, std::memory_order_relaxed); });
+
+        em::Sharded_counter<unsigned long> sharded;
+        s.run_threaded("3.10/counter/sharded" + suffix, t,
+                       [&sharded] (std::size_t) { ++sharded; });
+
+        Atomic_point ap{3.0, 4.0};
+        s.run_threaded("3.10/distance/atomic" + suffix, t, [&ap] (std::size_t)
+        { return ap.distance_from_origin(); });
+
+        Point p{3.0, 4.0};
+        s.run_threaded("3.10/distance/sharded" + suffix, t, [&p] (std::size_t)
+        { return p.distance_from_origin(); });
+    }
+}};
+
+} // namespace
+
+//------------------------------------------------------------------------------
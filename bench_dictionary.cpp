@@ -0,0 +1,154 @@
+//------------------------------------------------------------------------------
+
+// Бенчмарки к разделам 5.4 и 5.5: name_from_idx, возвращающая std::string
+// по значению, против em::Name_dictionary, отображенного в память;
+// загрузка словаря при старте - разбор текстового файла против mmap
+
+//------------------------------------------------------------------------------
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Alloc_counter.hpp"
+#include "Benchmark.hpp"
+#include "Name_dictionary.hpp"
+
+//------------------------------------------------------------------------------
+
+namespace {
+
+constexpr std::size_t name_count = std::size_t{1} << 16;
+constexpr std::size_t lookup_count = 4096;
+
+// Имена длиннее буфера SSO
+std::vector<std::string> make_names()
+{
+    std::mt19937_64 gen{42};
+    std::vector<std::string> names;
+    for (std::size_t i = 0; i < name_count; ++i)
+        names.push_back("person-" + std::to_string(i) + "-"
+                        + std::string(8 + gen() % 24, char('a' + i % 26)));
+    return names;
+}
+
+std::vector<int> make_indices()
+{
+    std::mt19937_64 gen{7};
+    std::vector<int> idx(lookup_count);
+    for (auto& i : idx) i = int(gen() % name_count);
+    return idx;
+}
+
+// Как в 5.4: словарь в памяти процесса, имя возвращается по значению
+class String_names {
+public:
+    explicit String_names(std::vector<std::string> n) : names{std::move(n)} {}
+
+    std::string name_from_idx(int idx) const { return names[std::size_t(idx)]; }
+private:
+    std::vector<std::string> names;
+};
+
+// Словарь, который приходится разбирать при каждом запуске: строка на имя
+std::vector<std::string> load_text(const std::string& path)
+{
+    std::ifstream in{path};
+    std::vector<std::string> names;
+    for (std::string line; std::getline(in, line); ) names.push_back(std::move(line));
+    return names;
+}
+
+template<class Op>
+void run_lookups(em::Bench_session& s, const std::string& name, Op op)
+{
+    auto* r = s.run(name, op);
+    if (!r) return;
+
+    em::Alloc_stats st;
+    {
+        em::Alloc_scope scope;
+        op();
+        st = scope.stats();
+    }
+    r->counter("ns/lookup", r->median.count() / lookup_count);
+    r->counter("allocs/lookup", double(st.allocations) / lookup_count);
+}
+
+em::Bench_registrar dictionary_suite{"5.4/name_from_idx", [] (em::Bench_session& s)
+{
+    const auto names = make_names();
+    const auto indices = make_indices();
+
+    auto dir = std::filesystem::temp_directory_path();
+    auto text_path = (dir / "em_bench_names.txt").string();
+    auto dict_path = (dir / "em_bench_names.dict").string();
+    {
+        std::ofstream out{text_path};
+        for (const auto& n : names) out << n << '\n';
+    }
+    em::write_name_dictionary(dict_path, names);
+
+    std::size_t expected = 0;
+    for (auto i : indices) expected += names[std::size_t(i)].size();
+
+    // Поиск: суммарная длина найденных имен
+    String_names strings{names};
+    std::size_t total = 0;
+    run_lookups(s, "5.4/name_from_idx/lookup/string", [&]
+    {
+        std::size_t sum = 0;
+        for (auto i : indices) sum += strings.name_from_idx(i).size();
+        total = sum;
+        em::do_not_optimize(total);
+    });
+    if (total && total != expected)
+        std::cerr << "5.4/name_from_idx/lookup/string: неверная сумма длин\n";
+
+    em::Name_dictionary dict{dict_path};
+    total = 0;
+    run_lookups(s, "5.4/name_from_idx/lookup/dictionary", [&]
+    {
+        std::size_t sum = 0;
+        for (auto i : indices) sum += dict[std::size_t(i)].size();
+        total = sum;
+        em::do_not_optimize(total);
+    });
+    if (total && total != expected)
+        std::cerr << "5.4/name_from_idx/lookup/dictionary: неверная сумма длин\n";
+
+    // Старт процесса: словарь готов к первому поиску
+    std::size_t loaded = 0;
+    s.run("5.4/name_from_idx/startup/parse_text", [&]
+    {
+        auto v = load_text(text_path);
+        loaded = v.size();
+        em::do_not_optimize(v);
+    });
+    if (loaded && loaded != name_count)
+        std::cerr << "5.4/name_from_idx/startup/parse_text: " << loaded
+                  << " имен вместо " << name_count << '\n';
+
+    loaded = 0;
+    s.run("5.4/name_from_idx/startup/mmap", [&]
+    {
+        em::Name_dictionary d{dict_path};
+        loaded = d.size();
+        em::do_not_optimize(d[0]);
+    });
+    if (loaded && loaded != name_count)
+        std::cerr << "5.4/name_from_idx/startup/mmap: " << loaded
+                  << " имен вместо " << name_count << '\n';
+
+    std::error_code ec;
+    std::filesystem::remove(text_path, ec);
+    std::filesystem::remove(dict_path, ec);
+}};
+
+} // namespace
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,86 @@
+//------------------------------------------------------------------------------
+
+// Бенчмарки к разделу 6.1: work_with_container, std::all_of с делением
+// против all_divisible
+
+//------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Benchmark.hpp"
+#include "Divisibility.hpp"
+
+//------------------------------------------------------------------------------
+
+namespace {
+
+constexpr std::size_t value_count = 1 << 22;
+
+// Все значения кратны divisor: худший случай, раннего выхода нет
+template<class T>
+std::vector<T> make_values(T divisor)
+{
+    std::vector<T> v(value_count);
+    for (std::size_t i = 0; i < v.size(); ++i)
+        v[i] = T((i % 97) * divisor);
+    return v;
+}
+
+void add_throughput(em::Bench_result* r)
+{
+    if (r) r->counter("Mvalues/s", value_count * 1e3 / r->median.count());
+}
+
+template<class T>
+void run_type(em::Bench_session& s, const std::string& type, T divisor)
+{
+    em::do_not_optimize(divisor);       // Делитель известен только в runtime
+    auto values = make_values(divisor);
+    auto prefix = "6.1/all_of/" + type + "/";
+
+    add_throughput(s.run(prefix + "std_all_of", [&]
+    {
+        return std::all_of(values.begin(), values.end(),
+                           [&] (const auto& value)
+                           { return value % divisor == 0; });
+    }));
+
+    const em::Divisor_test<T> test{divisor};
+    const auto top = em::simd_level();
+    for (auto level : {em::Simd_level::scalar, em::Simd_level::sse4,
+                       em::Simd_level::avx2}) {
+        if (top < level) break;
+        if (level != em::Simd_level::scalar && !em::has_simd_divisibility<T>) break;
+        em::set_simd_limit(level);
+        add_throughput(s.run(prefix + "serial/" + em::to_string(level), [&]
+        {
+            return em::find_not_divisible(std::span<const T>{values}, test)
+                   == values.size();
+        }));
+    }
+    em::set_simd_limit(em::Simd_level::avx2);
+
+    add_throughput(s.run(prefix + "parallel", [&]
+    { return em::all_divisible(values, divisor); }));
+
+    // Некратное значение в начале: ранний выход всех потоков
+    auto early = values;
+    early[values.size() / 16] += 1;
+    if (em::all_divisible(early, divisor))
+        std::cerr << prefix << ": некратное значение не найдено\n";
+    add_throughput(s.run(prefix + "parallel/early_exit", [&]
+    { return em::all_divisible(early, divisor); }));
+}
+
+em::Bench_registrar divisible_suite{"6.1/all_of", [] (em::Bench_session& s)
+{
+    run_type<int>(s, "int", 7);
+    run_type<short>(s, "short", 7);
+    run_type<long long>(s, "int64", 7);
+}};
+
+} // namespace
+
+//------------------------------------------------------------------------------
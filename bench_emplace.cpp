@@ -0,0 +1,210 @@
+//------------------------------------------------------------------------------
+
+// Бенчмарки к разделу 8.2: размещение (emplace) против вставки (push)
+
+//------------------------------------------------------------------------------
+
+#include <list>
+#include <memory>
+#include <regex>
+#include <string>
+#include <vector>
+#include "Alloc_counter.hpp"
+#include "Benchmark.hpp"
+
+//------------------------------------------------------------------------------
+
+namespace {
+
+constexpr std::size_t elems_per_op = 1000;      // Элементов за одну операцию
+constexpr std::size_t regexes_per_op = 16;      // std::regex дорогой
+
+const char short_literal[] = "xyzzy";           // Укладывается в SSO
+const char long_literal[] =                     // Не укладывается в SSO
+    "Supercalifgrawsxxxssswwlkjeryesdadasdxc";
+
+struct Widget {
+    int payload[8]{};
+};
+
+void kill_widget(Widget* p_widget) { delete p_widget; }
+
+//------------------------------------------------------------------------------
+// Число аллокаций на элемент за один вызов op
+
+template<class Op>
+double allocs_per_elem(Op& op, std::size_t elems)
+{
+    em::Alloc_scope scope;
+    op();
+    return static_cast<double>(scope.allocations()) / elems;
+}
+
+// Замер op и добавление счетчиков; op заполняет контейнер
+// elems элементами. Время в отчете - на одну операцию (elems элементов)
+template<class Op>
+void run_fill(em::Bench_session& s, std::string name, std::size_t elems, Op op)
+{
+    if (auto* r = s.run(name, op)) {
+        r->counter("ns/elem", r->median.count() / elems);
+        r->counter("allocs/elem", allocs_per_elem(op, elems));
+    }
+}
+
+//------------------------------------------------------------------------------
+// std::vector<std::string>: емкость сохраняется между операциями,
+// поэтому считаются только аллокации самих строк
+
+template<class Fill>
+auto vector_filler(Fill fill)
+{
+    return [fill, vs = std::vector<std::string>{}] () mutable
+    {
+        vs.clear();
+        vs.reserve(elems_per_op);
+        for (std::size_t i = 0; i < elems_per_op; ++i) fill(vs);
+        em::do_not_optimize(vs);
+    };
+}
+
+void strings_suite(em::Bench_session& s, const char* tag, const char* literal)
+{
+    std::string prefix{"8.2/vector<string>/"};
+    prefix += tag;
+
+    run_fill(s, prefix + "/literal/push_back", elems_per_op,
+             vector_filler([literal] (auto& vs) { vs.push_back(literal); }));
+    run_fill(s, prefix + "/literal/emplace_back", elems_per_op,
+             vector_filler([literal] (auto& vs) { vs.emplace_back(literal); }));
+
+    std::string lvalue{literal};
+    run_fill(s, prefix + "/lvalue/push_back", elems_per_op,
+             vector_filler([&lvalue] (auto& vs) { vs.push_back(lvalue); }));
+    run_fill(s, prefix + "/lvalue/emplace_back", elems_per_op,
+             vector_filler([&lvalue] (auto& vs) { vs.emplace_back(lvalue); }));
+
+    // rvalue: строка создается заранее и перемещается в контейнер;
+    // копирование в temps не входит в замер
+    std::vector<std::string> temps(elems_per_op, lvalue);
+    auto rvalue_filler = [&temps] (auto insert)
+    {
+        return [&temps, insert, vs = std::vector<std::string>{}] () mutable
+        {
+            vs.clear();
+            vs.reserve(elems_per_op);
+            for (auto& t : temps) insert(vs, std::move(t));
+            em::do_not_optimize(vs);
+            for (std::size_t i = 0; i < temps.size(); ++i)
+                temps[i].swap(vs[i]);   // Возврат строк без аллокаций
+        };
+    };
+    run_fill(s, prefix + "/rvalue/push_back", elems_per_op,
+             rvalue_filler([] (auto& vs, std::string&& t)
+                           { vs.push_back(std::move(t)); }));
+    run_fill(s, prefix + "/rvalue/emplace_back", elems_per_op,
+             rvalue_filler([] (auto& vs, std::string&& t)
+                           { vs.emplace_back(std::move(t)); }));
+
+    // Вставка в начало: emplace против insert с временным объектом
+    constexpr std::size_t front_elems = 64;
+    auto front_filler = [] (auto insert)
+    {
+        return [insert, vs = std::vector<std::string>{}] () mutable
+        {
+            vs.clear();
+            vs.reserve(front_elems);
+            for (std::size_t i = 0; i < front_elems; ++i) insert(vs);
+            em::do_not_optimize(vs);
+        };
+    };
+    run_fill(s, prefix + "/front/insert", front_elems,
+             front_filler([literal] (auto& vs)
+                          { vs.insert(vs.begin(), literal); }));
+    run_fill(s, prefix + "/front/emplace", front_elems,
+             front_filler([literal] (auto& vs)
+                          { vs.emplace(vs.begin(), literal); }));
+}
+
+//------------------------------------------------------------------------------
+// std::list<std::shared_ptr<Widget>> с удалителем kill_widget
+
+template<class Fill>
+auto list_filler(Fill fill)
+{
+    return [fill] ()
+    {
+        std::list<std::shared_ptr<Widget>> ptrs;
+        for (std::size_t i = 0; i < elems_per_op; ++i) fill(ptrs);
+        em::do_not_optimize(ptrs);
+    };
+}
+
+void shared_ptr_list_suite(em::Bench_session& s)
+{
+    const std::string prefix{"8.2/list<shared_ptr<Widget>>/"};
+
+    run_fill(s, prefix + "push_back(shared_ptr(new))", elems_per_op,
+             list_filler([] (auto& ptrs) {
+                 ptrs.push_back(std::shared_ptr<Widget>(new Widget,
+                                                        kill_widget));
+             }));
+    run_fill(s, prefix + "push_back({new, del})", elems_per_op,
+             list_filler([] (auto& ptrs) {
+                 ptrs.push_back({new Widget, kill_widget});
+             }));
+    run_fill(s, prefix + "emplace_back(new, del)", elems_per_op,
+             list_filler([] (auto& ptrs) {
+                 ptrs.emplace_back(new Widget, kill_widget);
+             }));
+    run_fill(s, prefix + "push_back(move(spw))", elems_per_op,
+             list_filler([] (auto& ptrs) {
+                 std::shared_ptr<Widget> spw(new Widget, kill_widget);
+                 ptrs.push_back(std::move(spw));
+             }));
+    run_fill(s, prefix + "emplace_back(move(spw))", elems_per_op,
+             list_filler([] (auto& ptrs) {
+                 std::shared_ptr<Widget> spw(new Widget, kill_widget);
+                 ptrs.emplace_back(std::move(spw));
+             }));
+}
+
+//------------------------------------------------------------------------------
+// std::vector<std::regex>
+
+void regex_suite(em::Bench_session& s)
+{
+    const std::string prefix{"8.2/vector<regex>/"};
+    auto regex_filler = [] (auto fill)
+    {
+        return [fill, regexes = std::vector<std::regex>{}] () mutable
+        {
+            regexes.clear();
+            regexes.reserve(regexes_per_op);
+            for (std::size_t i = 0; i < regexes_per_op; ++i) fill(regexes);
+            em::do_not_optimize(regexes);
+        };
+    };
+
+    run_fill(s, prefix + "push_back(regex(str))", regexes_per_op,
+             regex_filler([] (auto& regexes) {
+                 regexes.push_back(std::regex("[A-Z]+"));
+             }));
+    run_fill(s, prefix + "emplace_back(str)", regexes_per_op,
+             regex_filler([] (auto& regexes) {
+                 regexes.emplace_back("[A-Z]+");
+             }));
+}
+
+//------------------------------------------------------------------------------
+
+em::Bench_registrar emplace_suite{"8.2", [] (em::Bench_session& s)
+{
+    strings_suite(s, "sso", short_literal);
+    strings_suite(s, "long", long_literal);
+    shared_ptr_list_suite(s);
+    regex_suite(s);
+}};
+
+} // namespace
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,95 @@
+//------------------------------------------------------------------------------
+
+// Бенчмарки к разделу 6.1: Filter_container, вызываемый поэлементно,
+// против Filter_engine
+
+//------------------------------------------------------------------------------
+
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "Benchmark.hpp"
+#include "Filter_engine.hpp"
+
+//------------------------------------------------------------------------------
+
+namespace {
+
+using Filter_container = std::vector<std::function<bool(int)>>;
+
+constexpr std::size_t value_count = 1 << 20;
+
+std::vector<int> make_values()
+{
+    std::mt19937 gen{42};
+    std::uniform_int_distribution<int> dist{-1000000, 1000000};
+    std::vector<int> v(value_count);
+    for (auto& x : v) x = dist(gen);
+    return v;
+}
+
+Filter_container make_filters()
+{
+    Filter_container filters;
+    filters.emplace_back(em::Divisible_by{3});
+    filters.emplace_back([] (int value) { return value > -500000; });
+    filters.emplace_back(em::Divisible_by{5});
+    filters.emplace_back(em::Divisible_by{-4});
+    return filters;
+}
+
+// Как в книге: каждый фильтр для каждого значения
+void select_naive(const Filter_container& filters,
+                  const std::vector<int>& values, em::Bitmask& out)
+{
+    out.resize(values.size());
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        bool pass = true;
+        for (const auto& f : filters)
+            if (!f(values[i])) { pass = false; break; }
+        out.set(i, pass);
+    }
+}
+
+void add_throughput(em::Bench_result* r)
+{
+    if (r) r->counter("Mvalues/s", value_count * 1e3 / r->median.count());
+}
+
+em::Bench_registrar filter_suite{"6.1/filters", [] (em::Bench_session& s)
+{
+    auto values = make_values();
+    auto filters = make_filters();
+    em::Bitmask expected;
+    select_naive(filters, values, expected);
+
+    em::Bitmask out;
+    add_throughput(s.run("6.1/filters/std_function", [&]
+    {
+        select_naive(filters, values, out);
+        em::do_not_optimize(out);
+    }));
+
+    const em::Filter_engine engine{filters};
+    const auto top = em::simd_level();
+    for (auto level : {em::Simd_level::scalar, em::Simd_level::sse4,
+                       em::Simd_level::avx2}) {
+        if (top < level) break;
+        em::set_simd_limit(level);
+
+        auto name = std::string{"6.1/filters/engine/"} + em::to_string(level);
+        if (engine.select(values) != expected)
+            std::cerr << name << ": отбор не совпал с std::function\n";
+        add_throughput(s.run(name, [&]
+        {
+            engine.select(values, out);
+            em::do_not_optimize(out);
+        }));
+    }
+    em::set_simd_limit(em::Simd_level::avx2);
+}};
+
+} // namespace
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,147 @@
+//------------------------------------------------------------------------------
+
+// Бенчмарки к разделу 6.2: "validated И archived И НЕ processed" по
+// миллионам виджетов - вызовы через указатели против em::Widget_flags
+
+//------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "Benchmark.hpp"
+#include "Flag_store.hpp"
+
+//------------------------------------------------------------------------------
+
+namespace {
+
+constexpr std::size_t widget_count = std::size_t{1} << 22;
+
+class Widget {
+public:
+    Widget(bool v, bool p, bool a) : validated{v}, processed{p}, archived{a} {}
+
+    bool is_validated() const { return validated; }
+    bool is_processed() const { return processed; }
+    bool is_archived() const { return archived; }
+private:
+    std::string name{"widget"};         // Объект не из одних флагов
+    bool validated;
+    bool processed;
+    bool archived;
+};
+
+struct Population {
+    std::vector<std::unique_ptr<Widget>> widgets;
+    em::Widget_flags flags;
+};
+
+// Виджеты создаются в перемешанном порядке, как после долгой работы кучи
+Population make_population()
+{
+    std::mt19937_64 gen{42};
+    std::vector<std::unique_ptr<Widget>> pool;
+    pool.reserve(widget_count);
+    for (std::size_t i = 0; i < widget_count; ++i)
+        pool.push_back(std::make_unique<Widget>(gen() % 4 != 0, gen() % 2 == 0,
+                                                gen() % 3 != 0));
+    std::shuffle(pool.begin(), pool.end(), gen);
+
+    Population p{std::move(pool), em::Widget_flags{widget_count}};
+    for (std::size_t i = 0; i < widget_count; ++i) {
+        const auto& w = *p.widgets[i];
+        p.flags.set(i, em::Widget_flag::validated, w.is_validated());
+        p.flags.set(i, em::Widget_flag::processed, w.is_processed());
+        p.flags.set(i, em::Widget_flag::archived, w.is_archived());
+    }
+    return p;
+}
+
+void add_throughput(em::Bench_result* r)
+{
+    if (r) r->counter("Mwidgets/s", widget_count * 1e3 / r->median.count());
+}
+
+// Ответ на запрос, собранный обходом виджетов по указателям
+em::Bitmask reference_select(const Population& p)
+{
+    em::Bitmask ref{widget_count};
+    for (std::size_t i = 0; i < widget_count; ++i) {
+        const auto& w = *p.widgets[i];
+        ref.set(i, w.is_validated() && w.is_archived() && !w.is_processed());
+    }
+    return ref;
+}
+
+bool same_bits(const em::Bitmask& a, const em::Bitmask& b)
+{
+    return a.size() == b.size()
+           && std::equal(a.data(), a.data() + a.word_count(), b.data());
+}
+
+void count_suite(em::Bench_session& s)
+{
+    using em::Widget_flag;
+
+    auto p = make_population();
+    const auto query = em::Widget_flags::Query{}
+                           .with(Widget_flag::validated)
+                           .with(Widget_flag::archived)
+                           .without(Widget_flag::processed);
+
+    const auto reference = reference_select(p);
+    const auto expected = reference.count();
+
+    std::size_t n = 0;
+    auto* r = s.run("6.2/flags/count/pointers", [&]
+    {
+        std::size_t c = 0;
+        for (const auto& w : p.widgets)
+            c += w->is_validated() && w->is_archived() && !w->is_processed();
+        n = c;
+        em::do_not_optimize(c);
+    });
+    add_throughput(r);
+    if (r && n != expected)
+        std::cerr << r->name << ": " << n << " вместо " << expected << '\n';
+
+    em::Bitmask out;
+    const auto top = em::simd_level();
+    for (auto level : {em::Simd_level::scalar, em::Simd_level::sse4,
+                       em::Simd_level::avx2}) {
+        if (top < level) break;
+        em::set_simd_limit(level);
+
+        auto suffix = std::string{"/"} + em::to_string(level);
+        r = s.run("6.2/flags/count/flag_store" + suffix, [&]
+        {
+            n = p.flags.count(query);
+            em::do_not_optimize(n);
+        });
+        add_throughput(r);
+        if (r && n != expected)
+            std::cerr << r->name << ": count() = " << n << " вместо " << expected << '\n';
+
+        r = s.run("6.2/flags/select/flag_store" + suffix, [&]
+        {
+            n = p.flags.select(query, out);
+            em::do_not_optimize(out);
+        });
+        add_throughput(r);
+        if (r && (n != expected || out.count() != expected || !same_bits(out, reference)))
+            std::cerr << r->name << ": select() расходится с обходом по указателям\n";
+    }
+    em::set_simd_limit(em::Simd_level::avx2);
+}
+
+em::Bench_registrar flags_suite{"6.2/flags", [] (em::Bench_session& s)
+{
+    count_suite(s);
+}};
+
+} // namespace
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,146 @@
+//------------------------------------------------------------------------------
+
+// Бенчмарки к разделам 6.1 и 6.2: std::function против em::Unique_function -
+// создание замыканий с малым, большим и только перемещаемым захватом,
+// вызов фильтров Filter_container
+
+//------------------------------------------------------------------------------
+
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+#include "Alloc_counter.hpp"
+#include "Benchmark.hpp"
+#include "Unique_function.hpp"
+
+//------------------------------------------------------------------------------
+
+namespace {
+
+constexpr int closures_per_run = 1024;
+
+class Widget {
+public:
+    bool is_validated() const { return validated; }
+    bool is_archived() const { return archived; }
+private:
+    bool validated{true};
+    bool archived{true};
+};
+
+// Замер op и число аллокаций одного дополнительного прогона на замыкание
+template<class Op>
+void run_counted(em::Bench_session& s, const std::string& name, Op op)
+{
+    auto* r = s.run(name, op);
+    if (!r) return;
+
+    std::size_t allocs;
+    {
+        em::Alloc_scope scope;
+        op();
+        allocs = scope.allocations();
+    }
+    r->counter("ns/closure", r->median.count() / closures_per_run);
+    r->counter("allocs/closure", double(allocs) / closures_per_run);
+}
+
+//------------------------------------------------------------------------------
+// Создание, вызов и уничтожение
+
+template<class Function, class Make>
+void create_call(em::Bench_session& s, const std::string& name, Make make)
+{
+    run_counted(s, name, [&]
+    {
+        int sum = 0;
+        for (int i = 0; i < closures_per_run; ++i) {
+            Function f{make(i)};
+            em::do_not_optimize(f);             // Без девиртуализации
+            sum += f(i);
+        }
+        em::do_not_optimize(sum);
+    });
+}
+
+void closure_suite(em::Bench_session& s)
+{
+    using Std_fn = std::function<int(int)>;
+    using Unique_fn = em::Unique_function<int(int)>;
+    using Unique_fn64 = em::Unique_function<int(int), 64>;
+
+    // Захват двух int: обе обертки хранят его у себя
+    auto small = [] (int i) { return [a = i, b = i + 1] (int x) { return a + b + x; }; };
+    create_call<Std_fn>(s, "6.2/function/small/std_function", small);
+    create_call<Unique_fn>(s, "6.2/function/small/unique_function", small);
+
+    // Захват 48 байт: std::function уходит в кучу
+    auto large = [] (int i)
+    {
+        return [a = double(i), b = 1.0, c = 2.0, d = 3.0, e = 4.0, f = 5.0]
+               (int x) { return int(a + b + c + d + e + f) + x; };
+    };
+    create_call<Std_fn>(s, "6.2/function/large/std_function", large);
+    create_call<Unique_fn>(s, "6.2/function/large/unique_function", large);
+    create_call<Unique_fn64>(s, "6.2/function/large/unique_function_64", large);
+
+    // [pw = std::move(pw)]: std::function требует копируемости,
+    // поэтому unique_ptr приходится заменять на shared_ptr
+    create_call<Std_fn>(s, "6.2/function/move_only/std_function_shared_ptr",
+                        [] (int)
+                        {
+                            return [pw = std::make_shared<Widget>()] (int x)
+                            { return (pw->is_validated() && pw->is_archived()) + x; };
+                        });
+    create_call<Unique_fn>(s, "6.2/function/move_only/unique_function",
+                           [] (int)
+                           {
+                               return [pw = std::make_unique<Widget>()] (int x)
+                               { return (pw->is_validated() && pw->is_archived()) + x; };
+                           });
+}
+
+//------------------------------------------------------------------------------
+// Filter_container: вызов набора фильтров для каждого значения
+
+constexpr std::size_t value_count = 1 << 18;
+
+template<class Function>
+void filters(em::Bench_session& s, const std::string& name,
+             const std::vector<int>& values)
+{
+    std::vector<Function> fs;
+    for (int divisor : {2, 3, 5, 7}) {
+        em::do_not_optimize(divisor);
+        fs.emplace_back([divisor] (int value) { return value % divisor == 0; });
+    }
+
+    if (auto* r = s.run(name, [&]
+        {
+            std::size_t hits = 0;
+            for (auto v : values)
+                for (const auto& f : fs) hits += f(v);
+            em::do_not_optimize(hits);
+        }))
+        r->counter("ns/call", r->median.count() / double(values.size() * fs.size()));
+}
+
+void filter_suite(em::Bench_session& s)
+{
+    std::vector<int> values(value_count);
+    std::iota(values.begin(), values.end(), 1);
+    filters<std::function<bool(int)>>(s, "6.1/filters/call/std_function", values);
+    filters<em::Unique_function<bool(int)>>(s, "6.1/filters/call/unique_function", values);
+}
+
+em::Bench_registrar function_suite{"6.2/function", [] (em::Bench_session& s)
+{
+    closure_suite(s);
+    filter_suite(s);
+}};
+
+} // namespace
+
+//------------------------------------------------------------------------------
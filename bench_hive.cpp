@@ -0,0 +1,200 @@
+//------------------------------------------------------------------------------
+
+// Бенчмарки к разделу 8.2: реестр shared_ptr<Widget> с удалителем
+// kill_widget - std::list против em::Hive после удалений и вставок
+
+//------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "Benchmark.hpp"
+#include "Hive.hpp"
+
+//------------------------------------------------------------------------------
+
+namespace {
+
+constexpr std::size_t widget_count = std::size_t{1} << 18;
+
+struct Widget {
+    int payload[8]{};
+};
+
+std::size_t killed = 0;
+
+void kill_widget(Widget* p_widget)
+{
+    ++killed;
+    delete p_widget;
+}
+
+std::shared_ptr<Widget> make_widget(int id)
+{
+    std::shared_ptr<Widget> spw(new Widget, kill_widget);
+    spw->payload[0] = id;
+    return spw;
+}
+
+using Widget_list = std::list<std::shared_ptr<Widget>>;
+using Widget_hive = em::Hive<std::shared_ptr<Widget>>;
+
+Widget_list::iterator add(Widget_list& ptrs, int id)
+{
+    ptrs.push_back(make_widget(id));
+    return std::prev(ptrs.end());
+}
+
+Widget_hive::iterator add(Widget_hive& ptrs, int id) { return ptrs.insert(make_widget(id)); }
+
+// Реестр после долгой работы: половина виджетов удалена в случайном
+// порядке, на их место вставлены новые. Удаляются одни и те же id в
+// любом реестре; id_sum - сумма id оставшихся виджетов, посчитанная по
+// самим id, а не обходом реестра
+template<class Registry>
+Registry make_registry(long long& id_sum)
+{
+    Registry ptrs;
+    std::vector<typename Registry::iterator> its;
+    for (std::size_t i = 0; i < widget_count; ++i) its.push_back(add(ptrs, int(i)));
+    id_sum = (long long)(widget_count) * (widget_count - 1) / 2;
+
+    std::vector<std::size_t> ids(widget_count);
+    std::iota(ids.begin(), ids.end(), std::size_t{0});
+    std::mt19937_64 gen{42};
+    std::shuffle(ids.begin(), ids.end(), gen);
+    ids.resize(ids.size() / 2);
+    for (auto id : ids) {
+        ptrs.erase(its[id]);
+        id_sum -= (long long)(id);
+    }
+    for (std::size_t i = 0; i < ids.size(); ++i) {
+        add(ptrs, int(i));
+        id_sum += (long long)(i);
+    }
+    return ptrs;
+}
+
+void add_throughput(em::Bench_result* r)
+{
+    if (r) r->counter("ns/widget", r->median.count() / widget_count);
+}
+
+template<class Registry>
+void registry_suite(em::Bench_session& s, const std::string& prefix)
+{
+    add_throughput(s.run(prefix + "/fill", []
+    {
+        Registry ptrs;
+        for (std::size_t i = 0; i < widget_count; ++i) add(ptrs, int(i));
+        em::do_not_optimize(ptrs);
+    }));
+
+    long long expected = 0;
+    auto ptrs = make_registry<Registry>(expected);
+    if (ptrs.size() != widget_count)
+        std::cerr << prefix << ": size() = " << ptrs.size() << " вместо " << widget_count << '\n';
+
+    // Обход: сумма id и число посещенных элементов
+    long long sum = 0;
+    std::size_t visited = 0;
+    auto verify = [&] (const em::Bench_result* r)
+    {
+        if (!r) return;
+        if (sum != expected)
+            std::cerr << r->name << ": сумма " << sum << " вместо " << expected << '\n';
+        if (visited != ptrs.size())
+            std::cerr << r->name << ": посещено " << visited << " элементов, size() = "
+                      << ptrs.size() << '\n';
+    };
+
+    auto* r = s.run(prefix + "/traverse", [&]
+    {
+        long long acc = 0;
+        std::size_t n = 0;
+        for (const auto& spw : ptrs) {
+            acc += spw->payload[0];
+            ++n;
+        }
+        sum = acc;
+        visited = n;
+        em::do_not_optimize(sum);
+    });
+    add_throughput(r);
+    verify(r);
+
+    if constexpr (std::is_same_v<Registry, Widget_hive>) {
+        r = s.run(prefix + "/for_each", [&]
+        {
+            long long acc = 0;
+            std::size_t n = 0;
+            ptrs.for_each([&] (const auto& spw)
+            {
+                acc += spw->payload[0];
+                ++n;
+            });
+            sum = acc;
+            visited = n;
+            em::do_not_optimize(sum);
+        });
+        add_throughput(r);
+        verify(r);
+    }
+
+    // Удаление всех реестром вызывает kill_widget для каждого виджета
+    killed = 0;
+    auto n = ptrs.size();
+    ptrs = Registry{};
+    if (killed != n)
+        std::cerr << prefix << ": kill_widget вызван " << killed << " раз вместо " << n << '\n';
+}
+
+// Циклы заполнения и clear(): блоки заполняются заново, емкость не растет
+void clear_refill_check(const std::string& name)
+{
+    constexpr std::size_t per_cycle = 10000;
+    em::Hive<int> h;
+    std::size_t cap = 0;
+    for (int cycle = 0; cycle < 5; ++cycle) {
+        for (std::size_t i = 0; i < per_cycle; ++i) h.insert(int(i));
+
+        std::size_t visited = 0;
+        long long sum = 0;
+        for (auto v : h) {
+            sum += v;
+            ++visited;
+        }
+        if (h.size() != per_cycle || visited != per_cycle
+            || sum != (long long)(per_cycle) * (per_cycle - 1) / 2)
+            std::cerr << name << ": после заполнения " << cycle << " size() = " << h.size()
+                      << ", посещено " << visited << '\n';
+
+        if (!cap) cap = h.capacity();
+        if (h.capacity() != cap) {
+            std::cerr << name << ": емкость выросла с " << cap << " до " << h.capacity()
+                      << " после " << cycle << " clear()\n";
+            return;
+        }
+        h.clear();
+    }
+}
+
+em::Bench_registrar hive_suite{"8.2/registry", [] (em::Bench_session& s)
+{
+    registry_suite<Widget_list>(s, "8.2/registry/list");
+    registry_suite<Widget_hive>(s, "8.2/registry/hive");
+
+    const std::string refill = "8.2/registry/hive/clear_refill";
+    if (s.enabled(refill)) clear_refill_check(refill);
+}};
+
+} // namespace
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,105 @@
+//------------------------------------------------------------------------------
+
+// Бенчмарки к разделу 4.2: Widget::process() с shared_from_this
+// против интрузивного счетчика ссылок
+
+//------------------------------------------------------------------------------
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "Alloc_counter.hpp"
+#include "Benchmark.hpp"
+#include "Intrusive_ptr.hpp"
+
+//------------------------------------------------------------------------------
+
+namespace {
+
+constexpr std::size_t handles_per_op = 1000;
+
+struct Payload {
+    int data[8]{};
+};
+
+// Вариант из книги
+class Shared_widget : public std::enable_shared_from_this<Shared_widget> {
+public:
+    template<class... Ts>
+    static std::shared_ptr<Shared_widget> create(Ts&&... params)
+    { return std::make_shared<Shared_widget>(std::forward<Ts>(params)...); }
+
+    void process(std::vector<std::shared_ptr<Shared_widget>>& processed)
+    { processed.emplace_back(shared_from_this()); }
+private:
+    Payload payload;
+};
+
+// Интрузивный вариант; Policy - атомарный или обычный счетчик
+template<class Policy>
+class Basic_widget : public em::Ref_counted<Basic_widget<Policy>, Policy> {
+public:
+    template<class... Ts>
+    static em::Intrusive_ptr<Basic_widget> create(Ts&&... params)
+    { return em::make_intrusive<Basic_widget>(std::forward<Ts>(params)...); }
+
+    void process(std::vector<em::Intrusive_ptr<Basic_widget>>& processed)
+    { processed.emplace_back(this->ref_from_this()); }
+private:
+    friend em::Intrusive_access;
+    Basic_widget() = default;
+
+    Payload payload;
+};
+
+using Atomic_widget = Basic_widget<em::Atomic_refcount>;
+using Local_widget = Basic_widget<em::Local_refcount>;
+
+// Байт на объект: объект, счетчики и (для shared_ptr) слабый указатель
+template<class Make>
+std::size_t bytes_per_object(Make make)
+{
+    em::Alloc_scope scope;
+    auto p = make();
+    return scope.bytes();
+}
+
+// Одна операция: process() handles_per_op раз и уничтожение копий
+template<class Ptr>
+void run_handles(em::Bench_session& s, std::string name, Ptr w,
+                 std::size_t object_bytes)
+{
+    std::vector<Ptr> processed;
+    processed.reserve(handles_per_op);
+    if (auto* r = s.run(name, [&] {
+            for (std::size_t i = 0; i < handles_per_op; ++i)
+                w->process(processed);
+            em::do_not_optimize(processed);
+            processed.clear();
+        })) {
+        r->counter("ns/handle", r->median.count() / handles_per_op);
+        r->counter("handle_bytes", sizeof(Ptr));
+        r->counter("object_bytes", object_bytes);
+    }
+}
+
+em::Bench_registrar intrusive_suite{"4.2", [] (em::Bench_session& s)
+{
+    run_handles(s, "4.2/process/shared_from_this", Shared_widget::create(),
+                bytes_per_object([] { return Shared_widget::create(); }));
+    run_handles(s, "4.2/process/intrusive_atomic", Atomic_widget::create(),
+                bytes_per_object([] { return Atomic_widget::create(); }));
+    run_handles(s, "4.2/process/intrusive_local", Local_widget::create(),
+                bytes_per_object([] { return Local_widget::create(); }));
+
+    auto w = Atomic_widget::create();
+    em::Intrusive_weak_ptr<Atomic_widget> weak{w};
+    s.run("4.2/weak_lock/intrusive", [&weak] { return weak.lock().get(); });
+    auto sw = Shared_widget::create();
+    std::weak_ptr<Shared_widget> sweak{sw};
+    s.run("4.2/weak_lock/shared_ptr", [&sweak] { return sweak.lock().get(); });
+}};
+
+} // namespace
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,126 @@
+//------------------------------------------------------------------------------
+
+// Бенчмарки к разделу 4.1: пересборка портфеля из Investment
+// в куче против Slab_pool
+
+//------------------------------------------------------------------------------
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "Alloc_counter.hpp"
+#include "Benchmark.hpp"
+#include "Investment.hpp"
+
+//------------------------------------------------------------------------------
+
+namespace {
+
+constexpr std::size_t portfolio_size = 10000;
+
+// Та же иерархия, но в обычной куче
+namespace heap {
+
+class Investment {
+public:
+    Investment(std::string n, double v) : name{std::move(n)}, value{v} {}
+    virtual ~Investment() = default;
+private:
+    std::string name;
+    double value;
+};
+
+class Stock : public Investment {
+    using Investment::Investment;
+    int lots{0};
+};
+
+class Bond : public Investment {
+    using Investment::Investment;
+    double coupon{0};
+    long maturity{0};
+};
+
+class Real_estate : public Investment {
+    using Investment::Investment;
+    double area{0};
+    double lat{0}, lon{0};
+};
+
+std::unique_ptr<Investment> make_investment(em::Investment_kind kind,
+                                            std::string name, double value)
+{
+    switch (kind) {
+    case em::Investment_kind::stock:
+        return std::make_unique<Stock>(std::move(name), value);
+    case em::Investment_kind::bond:
+        return std::make_unique<Bond>(std::move(name), value);
+    default:
+        return std::make_unique<Real_estate>(std::move(name), value);
+    }
+}
+
+} // namespace heap
+
+em::Investment_kind kind_of(std::size_t i)
+{ return static_cast<em::Investment_kind>(i % 3); }
+
+// Одна операция - создание и уничтожение portfolio_size объектов
+template<class Make, class Ptr>
+auto rebuild(Make make, std::vector<Ptr>& portfolio)
+{
+    return [make, &portfolio]
+    {
+        for (std::size_t i = 0; i < portfolio_size; ++i)
+            portfolio.push_back(make(kind_of(i), "ACME", 1.0 * i));
+        em::do_not_optimize(portfolio);
+        portfolio.clear();
+    };
+}
+
+template<class Op>
+void run_rebuild(em::Bench_session& s, std::string name, Op op)
+{
+    auto* r = s.run(name, op);
+    if (!r) return;
+    em::Alloc_stats st;
+    {
+        em::Alloc_scope scope;
+        op();
+        st = scope.stats();
+    }
+    r->counter("ns/object", r->median.count() / portfolio_size);
+    r->counter("allocs/object", double(st.allocations) / portfolio_size);
+}
+
+em::Bench_registrar investment_suite{"4.1", [] (em::Bench_session& s)
+{
+    std::vector<std::unique_ptr<heap::Investment>> heap_portfolio;
+    heap_portfolio.reserve(portfolio_size);
+    run_rebuild(s, "4.1/rebuild/heap", rebuild(
+        [] (auto kind, const char* n, double v)
+        { return heap::make_investment(kind, n, v); }, heap_portfolio));
+
+    std::vector<std::unique_ptr<em::Investment>> slab_portfolio;
+    slab_portfolio.reserve(portfolio_size);
+    run_rebuild(s, "4.1/rebuild/slab", rebuild(
+        [] (auto kind, const char* n, double v)
+        { return std::unique_ptr<em::Investment>{
+                em::make_investment(kind, n, v).release()}; },
+        slab_portfolio));
+
+    // С удалителем из книги; журнал только форматирует записи
+    auto& log = em::Async_log::instance();
+    log.set_output(nullptr);
+    std::vector<em::Investment_ptr> logged_portfolio;
+    logged_portfolio.reserve(portfolio_size);
+    run_rebuild(s, "4.1/rebuild/slab+del_invmt", rebuild(
+        [] (auto kind, const char* n, double v)
+        { return em::make_investment(kind, n, v); }, logged_portfolio));
+    log.flush();
+    log.set_output(stderr);
+}};
+
+} // namespace
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,159 @@
+//------------------------------------------------------------------------------
+
+// Бенчмарки к разделу 3.10: Widget::magic_value на Lazy<T>
+// против версии с мьютексом; проверки Lazy при гонках потоков
+
+//------------------------------------------------------------------------------
+
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Benchmark.hpp"
+#include "Lazy.hpp"
+
+//------------------------------------------------------------------------------
+
+namespace {
+
+std::atomic<int> computations{0};
+
+int expensive_computation1() { ++computations; return 40; }
+int expensive_computation2() { return 2; }
+
+// Последняя (правильная) версия из книги
+class Locked_widget {
+public:
+    int magic_value() const
+    {
+        std::lock_guard<std::mutex> g{m};   // Блокировка мьютекса
+        if (cached_valid) return cached_value;
+        auto val1(expensive_computation1());
+        auto val2(expensive_computation2());
+        cached_value = val1 + val2;
+        cached_valid = true;
+        return cached_value;
+    }                                       // Разблокирование
+private:
+    mutable std::mutex m;
+    mutable bool cached_valid{false};
+    mutable int cached_value{0};
+};
+
+class Widget {
+public:
+    int magic_value() const
+    {
+        return cached.get([] {
+            auto val1(expensive_computation1());
+            auto val2(expensive_computation2());
+            return val1 + val2;
+        });
+    }
+
+    // Тип, который не уложить в std::atomic; длина без копирования
+    std::size_t description_size() const
+    {
+        return text.read([] {
+            ++computations;
+            return std::string(64, 'w');
+        }, [] (const std::string& d) { return d.size(); });
+    }
+private:
+    em::Lazy<int> cached;
+    em::Lazy<std::string> text;
+};
+
+// Проверка однократности вычисления: все потоки одновременно
+// обращаются к свежему Widget; возвращает число вычислений
+int race_first_access(int threads)
+{
+    computations = 0;
+    Widget w;
+    std::atomic<bool> go{false};
+    std::vector<std::thread> ts;
+    for (int t = 0; t < threads; ++t)
+        ts.emplace_back([&] {
+            while (!go) std::this_thread::yield();
+            if (w.magic_value() != 42 || w.description_size() != 64)
+                std::cerr << "Lazy: неверное значение\n";
+        });
+    go = true;
+    for (auto& t : ts) t.join();
+    return computations;
+}
+
+// Сброс кэша во время чтения: читатели обходят значение, пока писатель
+// публикует новые версии; возвращает число ошибок
+int race_invalidate(int readers)
+{
+    constexpr int versions = 2000;
+    em::Lazy<std::string> text;
+    std::atomic<int> version{0};
+    std::atomic<bool> done{false};
+    std::atomic<int> errors{0};
+
+    auto compute = [&version]
+    { return std::string(64, char('a' + version.load() % 26)); };
+
+    std::vector<std::thread> ts;
+    for (int t = 0; t < readers; ++t)
+        ts.emplace_back([&] {
+            while (!done) {
+                bool ok = text.read(compute, [] (const std::string& v) {
+                    std::this_thread::yield();  // Писатель тем временем сбрасывает
+                    return v.size() == 64
+                        && v.find_first_not_of(v.front()) == std::string::npos;
+                });
+                if (!ok) ++errors;
+            }
+        });
+    for (int v = 1; v <= versions; ++v) {
+        version = v;
+        text.invalidate();
+        if (v % 64 == 0) std::this_thread::yield();
+    }
+    done = true;
+    for (auto& t : ts) t.join();
+
+    if (text.get(compute) != std::string(64, char('a' + versions % 26))) ++errors;
+    return errors;
+}
+
+em::Bench_registrar lazy_suite{"lazy", [] (em::Bench_session& s)
+{
+    int hw = static_cast<int>(std::thread::hardware_concurrency());
+    int threads = hw > 1 ? hw : 2;
+
+    // Проверки только при выбранных бенчмарках Lazy
+    const std::string lazy_names[] = {"3.10/magic_value/lazy", "3.10/description/lazy"};
+    if (s.enabled(lazy_names[0]) || s.enabled(lazy_names[1])) {
+        for (int round = 0; round < 100; ++round)
+            if (auto n = race_first_access(threads); n != 2) {
+                std::cerr << "Lazy: " << n << " вычислений вместо 2\n";
+                break;
+            }
+        if (auto n = race_invalidate(threads))
+            std::cerr << "Lazy: " << n << " неверных снимков при invalidate()\n";
+    }
+
+    Locked_widget locked;
+    Widget lazy;
+    for (int t = 1; t <= threads; t *= 2) {
+        auto suffix = "/threads:" + std::to_string(t);
+        s.run_threaded("3.10/magic_value/mutex" + suffix, t,
+                       [&locked] (std::size_t) { return locked.magic_value(); });
+        s.run_threaded("3.10/magic_value/lazy" + suffix, t,
+                       [&lazy] (std::size_t) { return lazy.magic_value(); });
+        s.run_threaded("3.10/description/lazy" + suffix, t,
+                       [&lazy] (std::size_t) {
+            return lazy.description_size();
+        });
+    }
+}};
+
+} // namespace
+
+//------------------------------------------------------------------------------
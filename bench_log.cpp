@@ -0,0 +1,77 @@
+//------------------------------------------------------------------------------
+
+// Бенчмарки make_log_entry: асинхронный журнал против записи
+// под общим мьютексом
+
+//------------------------------------------------------------------------------
+
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include "Async_log.hpp"
+#include "Benchmark.hpp"
+
+//------------------------------------------------------------------------------
+
+namespace {
+
+struct Investment {};
+
+// Журнал с общим мьютексом и форматированием в вызывающем потоке;
+// ввода-вывода нет, поэтому это нижняя оценка для синхронного журнала
+class Locked_log {
+public:
+    void write(const char* text, const void* p)
+    {
+        std::lock_guard<std::mutex> g{m};
+        char tmp[128];
+        auto n = std::snprintf(tmp, sizeof tmp, "%s %p\n", text, p);
+        buf.append(tmp, static_cast<std::size_t>(n));
+        if (buf.size() > (1 << 20)) buf.clear();
+    }
+private:
+    std::mutex m;
+    std::string buf;
+};
+
+em::Bench_registrar log_suite{"log", [] (em::Bench_session& s)
+{
+    auto& log = em::Async_log::instance();
+    log.set_output(nullptr);            // Только форматирование
+    auto dropped_before = log.dropped();
+
+    Investment inv;
+    Investment* p_investment = &inv;
+    if (auto* r = s.run("log/make_log_entry(ptr)", [&] {
+            make_log_entry(p_investment);
+        }))
+        r->counter("dropped", log.dropped() - dropped_before);
+
+    dropped_before = log.dropped();
+    if (auto* r = s.run("log/make_log_entry(literal, time)", [] {
+            auto now = std::chrono::system_clock::now();
+            make_log_entry("Вызов 'process'", now);
+        }))
+        r->counter("dropped", log.dropped() - dropped_before);
+
+    dropped_before = log.dropped();
+    if (auto* r = s.run("log/make_log_entry(static_text, time)", [] {
+            static constexpr auto call = em::static_text("Вызов 'process'");
+            auto now = std::chrono::system_clock::now();
+            make_log_entry(call, now);
+        }))
+        r->counter("dropped", log.dropped() - dropped_before);
+
+    Locked_log locked;
+    s.run("log/locked_snprintf(literal, ptr)", [&] {
+        locked.write("Уничтожение String_table", p_investment);
+    });
+
+    log.flush();
+    log.set_output(stderr);
+}};
+
+} // namespace
+
+//------------------------------------------------------------------------------
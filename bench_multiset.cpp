@@ -0,0 +1,212 @@
+//------------------------------------------------------------------------------
+
+// Бенчмарки к разделам 5.4 и 5.5: log_and_add из многих потоков -
+// std::multiset<std::string> под мьютексом с журнальной записью на каждую
+// вставку против em::Concurrent_multiset с записью раз на пачку
+
+//------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "Benchmark.hpp"
+#include "Concurrent_multiset.hpp"
+
+//------------------------------------------------------------------------------
+
+namespace {
+
+using Clock = std::chrono::system_clock;
+
+constexpr std::size_t name_count = 4096;
+constexpr std::size_t names_per_op = 256;         // Одна пачка по умолчанию
+// Имен до замера: иначе размер множества зависел бы от числа итераций,
+// которое калибровка выбирает для каждого варианта по-своему
+constexpr std::size_t prefill = std::size_t{1} << 18;
+
+std::vector<std::string> make_names()
+{
+    std::vector<std::string> names;
+    for (std::size_t i = 0; i < name_count; ++i)
+        names.push_back("pet-" + std::to_string(i * 2654435761u % 100000));
+    return names;
+}
+
+// Журнал: последняя отметка времени и число записей
+class Log {
+public:
+    void log(Clock::time_point now, const char*)
+    {
+        std::lock_guard<std::mutex> g{m};
+        last = now;
+        ++records;
+    }
+
+    std::size_t size()
+    {
+        std::lock_guard<std::mutex> g{m};
+        return records;
+    }
+private:
+    std::mutex m;
+    Clock::time_point last;
+    std::size_t records{0};
+};
+
+// Версия из книги, но с мьютексом, без которого вставки из разных
+// потоков - гонка данных
+class Locked_names {
+public:
+    explicit Locked_names(Log& l) : journal{&l} {}
+
+    template<class T>
+    void log_and_add(T&& name)
+    {
+        auto now = Clock::now();
+        journal->log(now, "log_and_add");
+        std::lock_guard<std::mutex> g{m};
+        names.emplace(std::forward<T>(name));
+    }
+
+    bool sorted() { return std::is_sorted(names.begin(), names.end()); }
+    std::size_t size() { return names.size(); }
+private:
+    Log* journal;
+    std::mutex m;
+    std::multiset<std::string> names;
+};
+
+class Batched_names {
+public:
+    explicit Batched_names(Log& l)
+        : names{{.on_batch = [&l] (Clock::time_point now, std::size_t)
+                             { l.log(now, "log_and_add"); }}} {}
+
+    template<class T>
+    void log_and_add(T&& name) { names.emplace(std::forward<T>(name)); }
+
+    bool sorted()
+    {
+        const std::string* prev = nullptr;
+        bool ok = true;
+        names.for_each([&] (const std::string& n)
+        {
+            if (prev && n < *prev) ok = false;
+            prev = &n;
+        });
+        return ok;
+    }
+
+    std::size_t size() { return names.size(); }
+private:
+    em::Concurrent_multiset<std::string> names;
+};
+
+// Медиана - время одного op в каждом потоке, так что все threads потоков
+// вставляют threads * names_per_op имен за это время
+void add_metrics(em::Bench_result* r, int threads, std::size_t records, std::size_t inserted)
+{
+    if (!r) return;
+    r->counter("Mnames/s", threads * names_per_op * 1e3 / r->median.count());
+    r->counter("names/log", double(inserted) / double(records ? records : 1));
+}
+
+template<class Names>
+void names_suite(em::Bench_session& s, const std::string& prefix,
+                 const std::vector<std::string>& pool, int threads)
+{
+    auto name = prefix + "/threads:" + std::to_string(threads);
+    if (!s.enabled(name)) return;
+
+    Log journal;
+    Names names{journal};
+    for (std::size_t i = 0; i < prefill; ++i) names.log_and_add(pool[i % pool.size()]);
+    auto* r = s.run_threaded(name, threads, [&] (std::size_t tid)
+    {
+        thread_local std::size_t i = 0;
+        for (std::size_t k = 0; k < names_per_op; ++k)
+            names.log_and_add(pool[(i++ * 7 + tid) % pool.size()]);
+    });
+    if (!r) return;
+
+    auto inserted = names.size();
+    add_metrics(r, threads, journal.size(), inserted);
+    if (!names.sorted())
+        std::cerr << prefix << ": обход не упорядочен\n";
+}
+
+// Сравнение уступает процессор: сортировка полного буфера растягивается,
+// и другой поток успевает прийти с запросом посреди вливания
+struct Yielding_less {
+    bool operator()(const std::string& a, const std::string& b) const
+    {
+        std::this_thread::yield();
+        return a < b;
+    }
+};
+
+// Вставка в одном потоке, передача другому и count в нем: вставка видна,
+// даже если буфер с ней в это же время вливает третий поток. Один шард,
+// чтобы буфер вставки заполнил именно третий поток
+void handoff_check(const std::string& name, const std::vector<std::string>& pool)
+{
+    constexpr std::size_t batch = 16;
+    for (int round = 0; round < 20; ++round) {
+        em::Concurrent_multiset<std::string, Yielding_less, 1> names{
+            {.batch = batch, .on_batch = {}}};
+        const std::string key = "handoff";
+        std::atomic<int> stage{0};
+        std::size_t seen = 0;
+
+        std::thread writer{[&]
+        {
+            names.insert(key);
+            stage.store(1);
+        }};
+        std::thread filler{[&]
+        {
+            while (stage.load() < 1) std::this_thread::yield();
+            for (std::size_t k = 0; k + 2 < batch; ++k) names.insert(pool[k]);
+            stage.store(2);
+            names.insert(pool[batch]);          // Заполняет буфер с key
+        }};
+        std::thread reader{[&]
+        {
+            while (stage.load() < 2) std::this_thread::yield();
+            seen = names.count(key);
+        }};
+        writer.join();
+        filler.join();
+        reader.join();
+
+        if (seen != 1) {
+            std::cerr << name << ": count() после передачи = " << seen << " вместо 1\n";
+            return;
+        }
+    }
+}
+
+em::Bench_registrar multiset_suite{"5.4/log_and_add", [] (em::Bench_session& s)
+{
+    const auto pool = make_names();
+    int hw = static_cast<int>(std::thread::hardware_concurrency());
+    for (int t = 1; t <= (hw > 1 ? hw : 2); t *= 2) {
+        names_suite<Locked_names>(s, "5.4/log_and_add/locked_multiset", pool, t);
+        names_suite<Batched_names>(s, "5.4/log_and_add/concurrent_multiset", pool, t);
+    }
+
+    const std::string handoff = "5.4/log_and_add/concurrent_multiset/handoff";
+    if (s.enabled(handoff)) handoff_check(handoff, pool);
+}};
+
+} // namespace
+
+//------------------------------------------------------------------------------
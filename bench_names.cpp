@@ -0,0 +1,176 @@
+//------------------------------------------------------------------------------
+
+// Бенчмарки к разделу 8.1: add_name(std::string) с std::vector<std::string>
+// против имен, интернированных в em::Name_store
+
+//------------------------------------------------------------------------------
+
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "Alloc_counter.hpp"
+#include "Benchmark.hpp"
+#include "Name_store.hpp"
+
+//------------------------------------------------------------------------------
+
+namespace {
+
+constexpr std::size_t widget_count = std::size_t{1} << 16;
+constexpr std::size_t names_per_widget = 4;
+constexpr std::size_t vocabulary_size = 512;
+
+// Как в 8.1: каждое имя - свой std::string
+class Widget {
+public:
+    void add_name(std::string new_name)
+    { names.push_back(std::move(new_name)); }
+
+    std::size_t name_count() const noexcept { return names.size(); }
+    std::string_view name(std::size_t i) const noexcept { return names[i]; }
+private:
+    std::vector<std::string> names;
+};
+
+// Байты имен - в общем хранилище. add_name принимает std::string_view:
+// std::string, const char* и литерал передаются без построения
+// std::string, и при повторном имени куча не трогается вовсе
+class Interned_widget {
+public:
+    explicit Interned_widget(em::Name_store& store) : store{&store} {}
+
+    void add_name(std::string_view new_name)
+    { names.push_back(store->intern(new_name)); }
+
+    std::size_t name_count() const noexcept { return names.size(); }
+    std::string_view name(std::size_t i) const noexcept { return names[i]; }
+private:
+    em::Name_store* store;
+    std::vector<em::Interned_name> names;
+};
+
+// Имена длиннее буфера SSO
+std::vector<std::string> make_vocabulary()
+{
+    std::mt19937_64 gen{42};
+    std::vector<std::string> words;
+    for (std::size_t i = 0; i < vocabulary_size; ++i)
+        words.push_back("widget-category-" + std::to_string(i) + "-"
+                        + std::string(gen() % 16, 'x'));
+    return words;
+}
+
+std::vector<std::size_t> make_choices()
+{
+    std::mt19937_64 gen{7};
+    std::vector<std::size_t> choices(widget_count * names_per_widget);
+    for (auto& c : choices) c = gen() % vocabulary_size;
+    return choices;
+}
+
+// Замер op со счетчиками одного дополнительного прогона на имя и виджет
+template<class Op>
+void run_counted(em::Bench_session& s, const std::string& name, Op op)
+{
+    auto* r = s.run(name, op);
+    if (!r) return;
+
+    em::Alloc_stats st;
+    {
+        em::Alloc_scope scope;
+        op();
+        st = scope.stats();
+    }
+    constexpr double names = widget_count * names_per_widget;
+    r->counter("ns/name", r->median.count() / names);
+    r->counter("allocs/name", st.allocations / names);
+    r->counter("peak_bytes/widget", double(st.peak_live_bytes) / widget_count);
+}
+
+template<class W>
+void check(const char* name, const std::vector<W>& widgets,
+           const std::vector<std::string>& words, const std::vector<std::size_t>& choices)
+{
+    for (std::size_t i = 0; i < widgets.size(); ++i) {
+        for (std::size_t k = 0; k < names_per_widget; ++k) {
+            if (widgets[i].name(k) != words[choices[i * names_per_widget + k]]) {
+                std::cerr << name << ": неверное имя виджета " << i << '\n';
+                return;
+            }
+        }
+    }
+}
+
+// add(widget, const std::string&) - как вызывающий передает имя
+template<class W, class Make, class Add>
+std::vector<W> build(const std::vector<std::string>& words,
+                     const std::vector<std::size_t>& choices, Make make, Add add)
+{
+    std::vector<W> ws;
+    ws.reserve(widget_count);
+    for (std::size_t i = 0; i < widget_count; ++i) ws.push_back(make());
+    for (std::size_t i = 0; i < choices.size(); ++i)
+        add(ws[i / names_per_widget], words[choices[i]]);
+    return ws;
+}
+
+template<class W>
+void add_by_value(W& w, const std::string& name) { w.add_name(std::string{name}); }
+
+template<class W>
+void add_by_view(W& w, const std::string& name) { w.add_name(std::string_view{name}); }
+
+em::Bench_registrar names_suite{"8.1/add_name", [] (em::Bench_session& s)
+{
+    const auto words = make_vocabulary();
+    const auto choices = make_choices();
+
+    auto strings = [&]
+    { return build<Widget>(words, choices, [] { return Widget{}; }, add_by_value<Widget>); };
+    bool ran = false;
+    run_counted(s, "8.1/add_name/vector<string>", [&]
+    {
+        auto ws = strings();
+        em::do_not_optimize(ws);
+        ran = true;
+    });
+    if (ran) check("8.1/add_name/vector<string>", strings(), words, choices);
+
+    // Хранилище создается заново в каждом прогоне. /string - вызывающий
+    // по-прежнему строит std::string на каждое имя, как для add_name из
+    // книги; /string_view - имя передается без копии
+    using Add = void (*)(Interned_widget&, const std::string&);
+    auto interned = [&] (em::Name_store& store, Add add)
+    {
+        return build<Interned_widget>(words, choices,
+                                      [&] { return Interned_widget{store}; }, add);
+    };
+    const std::pair<std::string, Add> variants[] = {
+        {"8.1/add_name/name_store/string", add_by_value<Interned_widget>},
+        {"8.1/add_name/name_store/string_view", add_by_view<Interned_widget>},
+    };
+    for (const auto& [name, add] : variants) {
+        ran = false;
+        run_counted(s, name, [&]
+        {
+            em::Name_store store;
+            auto ws = interned(store, add);
+            em::do_not_optimize(ws);
+            ran = true;
+        });
+        if (!ran) continue;
+
+        em::Name_store store;
+        check(name.c_str(), interned(store, add), words, choices);
+        if (store.size() != vocabulary_size)
+            std::cerr << name << ": " << store.size()
+                      << " имен вместо " << vocabulary_size << '\n';
+    }
+}};
+
+} // namespace
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,176 @@
+//------------------------------------------------------------------------------
+
+// Бенчмарки к разделу 6.3: normalize для векторов признаков - копия по
+// значению (auto x) против rvalue на месте и lvalue в буфер вызывающего,
+// скалярные ядра против AVX2
+
+//------------------------------------------------------------------------------
+
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "Alloc_counter.hpp"
+#include "Benchmark.hpp"
+#include "Normalize.hpp"
+
+//------------------------------------------------------------------------------
+
+namespace {
+
+constexpr std::size_t feature_count = std::size_t{1} << 20;
+
+const char* to_string(em::Norm kind) noexcept
+{
+    switch (kind) {
+    case em::Norm::min_max: return "min_max";
+    case em::Norm::z_score: return "z_score";
+    default:                return "l2";
+    }
+}
+
+template<class T>
+std::vector<T> make_features()
+{
+    std::mt19937_64 gen{42};
+    std::normal_distribution<double> dist{3.0, 2.0};
+    std::vector<T> v(feature_count);
+    for (auto& x : v) x = T(dist(gen));
+    return v;
+}
+
+// Замер op, пропускная способность и аллокации одного дополнительного прогона
+template<class Op>
+void run_counted(em::Bench_session& s, const std::string& name, Op op)
+{
+    auto* r = s.run(name, op);
+    if (!r) return;
+
+    std::size_t allocs;
+    {
+        em::Alloc_scope scope;
+        op();
+        allocs = scope.allocations();
+    }
+    r->counter("Mvalues/s", feature_count * 1e3 / r->median.count());
+    r->counter("allocs", double(allocs));
+}
+
+// Сравнение с эталоном скалярного ядра
+template<class T>
+void check(const std::string& name, const std::vector<T>& got, const std::vector<T>& expected)
+{
+    const double tolerance = sizeof(T) == 4 ? 1e-4 : 1e-10;
+    for (std::size_t i = 0; i < got.size(); ++i) {
+        if (!(std::abs(double(got[i]) - double(expected[i])) <= tolerance)) {
+            std::cerr << name << ": [" << i << "] = " << got[i]
+                      << " вместо " << expected[i] << '\n';
+            return;
+        }
+    }
+}
+
+// Вход у границ диапазона T. Нормализация не зависит от масштаба, поэтому
+// эталон - тот же вектор без множителя scale (степени двойки)
+template<class T>
+void range_check(const std::string& name, em::Norm kind, T scale)
+{
+    std::vector<T> unit(19), scaled(unit.size());
+    for (std::size_t i = 0; i < unit.size(); ++i) {
+        unit[i] = T(i % 5);
+        scaled[i] = unit[i] * scale;
+    }
+    std::vector<T> expected, got;
+    em::normalize(unit, expected, kind);
+
+    const auto top = em::simd_level();
+    for (auto level : {em::Simd_level::scalar, em::Simd_level::avx2}) {
+        if (top < level) break;
+        em::set_simd_limit(level);
+        em::normalize(scaled, got, kind);
+        check(name + "/" + em::to_string(level), got, expected);
+    }
+    em::set_simd_limit(em::Simd_level::avx2);
+}
+
+template<class T>
+void kind_suite(em::Bench_session& s, const std::string& type, em::Norm kind)
+{
+    const auto source = make_features<T>();
+    const auto prefix = "6.3/normalize/" + type + "/" + to_string(kind);
+
+    // float - денормализованный вход и вход у FLT_MAX; у double редукции
+    // (сумма квадратов) сами теряют такие значения, поэтому только min-max
+    const auto range = prefix + "/range";
+    if (s.enabled(range)) {
+        if constexpr (std::is_same_v<T, float>) {
+            range_check<T>(range + "/denormal", kind, 0x1p-140f);
+            range_check<T>(range + "/huge", kind, 0x1p125f);
+        }
+        else if (kind == em::Norm::min_max) {
+            range_check<T>(range + "/denormal", kind, 0x1p-1070);
+            range_check<T>(range + "/huge", kind, 0x1p1021);
+        }
+    }
+
+    em::set_simd_limit(em::Simd_level::scalar);
+    std::vector<T> expected;
+    em::normalize(source, expected, kind);
+    em::set_simd_limit(em::Simd_level::avx2);
+
+    // Как у [](auto x) { return normalize(x); }: копия на каждый вызов
+    std::vector<T> result;
+    run_counted(s, prefix + "/by_value", [&]
+    {
+        auto x = source;
+        result = em::normalize(std::move(x), kind);
+        em::do_not_optimize(result);
+    });
+
+    const auto top = em::simd_level();
+    for (auto level : {em::Simd_level::scalar, em::Simd_level::avx2}) {
+        if (top < level) break;
+        em::set_simd_limit(level);
+        const auto suffix = std::string{"/"} + em::to_string(level);
+
+        // rvalue: повторная нормализация той же памяти (L2 и z-score
+        // нормализованного вектора не меняют его, min-max - тоже)
+        auto v = source;
+        bool ran = false;
+        run_counted(s, prefix + "/rvalue" + suffix, [&]
+        {
+            v = em::normalize(std::move(v), kind);
+            em::do_not_optimize(v);
+            ran = true;
+        });
+        if (ran) check(prefix + "/rvalue" + suffix, v, expected);
+
+        std::vector<T> out;
+        run_counted(s, prefix + "/lvalue" + suffix, [&]
+        {
+            em::normalize(source, out, kind);
+            em::do_not_optimize(out);
+        });
+        if (!out.empty()) check(prefix + "/lvalue" + suffix, out, expected);
+    }
+    em::set_simd_limit(em::Simd_level::avx2);
+}
+
+template<class T>
+void type_suite(em::Bench_session& s, const std::string& type)
+{
+    for (auto kind : {em::Norm::l2, em::Norm::min_max, em::Norm::z_score})
+        kind_suite<T>(s, type, kind);
+}
+
+em::Bench_registrar normalize_suite{"6.3/normalize", [] (em::Bench_session& s)
+{
+    type_suite<float>(s, "float");
+    type_suite<double>(s, "double");
+}};
+
+} // namespace
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,82 @@
+//------------------------------------------------------------------------------
+
+// Бенчмарки к разделу 3.10: кэш корней Polynomial под мьютексом
+// против публикации неизменяемого снимка, от 1 до N потоков
+
+//------------------------------------------------------------------------------
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Benchmark.hpp"
+#include "Polynomial.hpp"
+
+//------------------------------------------------------------------------------
+
+namespace {
+
+// Версия из книги: мьютекс на каждый вызов и возврат по значению
+class Locked_polynomial {
+public:
+    using Root_type = std::vector<double>;
+
+    explicit Locked_polynomial(std::vector<double> c)
+        : coeffs{std::move(c)} {}
+
+    Root_type roots() const
+    {
+        std::lock_guard<std::mutex> g{m};   // Блокировка мьютекса
+        if (!roots_are_valid) {
+            root_vals = em::find_real_roots(coeffs);
+            roots_are_valid = true;
+        }
+        return root_vals;
+    }                                       // Разблокирование
+private:
+    std::vector<double> coeffs;
+    mutable std::mutex m;
+    mutable bool roots_are_valid{false};
+    mutable Root_type root_vals{};
+};
+
+std::vector<int> thread_counts()
+{
+    int hw = static_cast<int>(std::thread::hardware_concurrency());
+    std::vector<int> counts;
+    for (int t = 1; t < hw; t *= 2) counts.push_back(t);
+    counts.push_back(hw > 0 ? hw : 1);
+    return counts;
+}
+
+// (x - 1)(x - 2)(x - 3)(x - 4)
+const std::vector<double> coeffs{24, -50, 35, -10, 1};
+
+em::Bench_registrar polynomial_suite{"3.10", [] (em::Bench_session& s)
+{
+    Locked_polynomial locked{coeffs};
+    em::Polynomial published{coeffs};
+
+    for (int t : thread_counts()) {
+        auto suffix = "/threads:" + std::to_string(t);
+
+        s.run_threaded("3.10/roots/mutex+copy" + suffix, t,
+                       [&locked] (std::size_t) {
+            auto r = locked.roots();
+            em::do_not_optimize(r);
+        });
+        s.run_threaded("3.10/roots/snapshot+copy" + suffix, t,
+                       [&published] (std::size_t) {
+            auto r = published.roots();
+            em::do_not_optimize(r);
+        });
+        s.run_threaded("3.10/visit_roots/snapshot" + suffix, t,
+                       [&published] (std::size_t) {
+            return published.visit_roots([] (const auto& r) { return r.front(); });
+        });
+    }
+}};
+
+} // namespace
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,206 @@
+//------------------------------------------------------------------------------
+
+// Бенчмарки к разделу 6.2: выполнение замыканий с перемещенными данными -
+// std::async, пул с одной общей очередью и em::Thread_pool
+
+//------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Benchmark.hpp"
+#include "Thread_pool.hpp"
+
+//------------------------------------------------------------------------------
+
+namespace {
+
+// Пул с одной очередью под одним мьютексом - то, от чего уходит
+// em::Thread_pool
+class Global_queue_pool {
+public:
+    explicit Global_queue_pool(std::size_t threads)
+    {
+        for (std::size_t i = 0; i < threads; ++i)
+            workers.emplace_back([this] { run(); });
+    }
+
+    ~Global_queue_pool()
+    {
+        {
+            std::lock_guard<std::mutex> g{m};
+            stop = true;
+        }
+        cv.notify_all();
+        for (auto& t : workers) t.join();
+    }
+
+    template<class F>
+    auto submit(F f)
+    {
+        std::packaged_task<std::invoke_result_t<F&>()> task{std::move(f)};
+        auto result = task.get_future();
+        {
+            std::lock_guard<std::mutex> g{m};
+            tasks.emplace_back(std::move(task));
+        }
+        cv.notify_one();
+        return result;
+    }
+private:
+    void run()
+    {
+        for (;;) {
+            em::Unique_function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock{m};
+                cv.wait(lock, [this] { return stop || !tasks.empty(); });
+                if (tasks.empty()) return;
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::mutex m;
+    std::condition_variable cv;
+    std::deque<em::Unique_function<void()>> tasks;
+    bool stop{false};
+    std::vector<std::thread> workers;
+};
+
+//------------------------------------------------------------------------------
+// Много мелких задач, каждой перемещен свой vector<double>
+
+constexpr int tasks_per_run = 4096;
+constexpr std::size_t doubles_per_task = 256;
+
+std::vector<std::vector<double>> make_batches()
+{
+    return std::vector<std::vector<double>>(
+               tasks_per_run, std::vector<double>(doubles_per_task, 0.5));
+}
+
+constexpr double expected_sum = tasks_per_run * doubles_per_task * 0.5;
+
+template<class Submit>
+void fan_out(em::Bench_session& s, const std::string& name, Submit submit)
+{
+    double sum = 0;
+    auto* r = s.run(name, [&]
+    {
+        auto batches = make_batches();
+        std::vector<decltype(submit(std::move(batches[0])))> results;
+        results.reserve(tasks_per_run);
+        for (auto& b : batches) results.push_back(submit(std::move(b)));
+        sum = 0;
+        for (auto& f : results) sum += f.get();
+    });
+    if (!r) return;
+    r->counter("ns/task", r->median.count() / double(tasks_per_run));
+    if (sum != expected_sum)
+        std::cerr << name << ": сумма " << sum << " вместо " << expected_sum << '\n';
+}
+
+auto summing(std::vector<double>&& data)
+{
+    return [data = std::move(data)]     // Инициализирующий захват
+           { return std::accumulate(data.begin(), data.end(), 0.0); };
+}
+
+void fan_out_suite(em::Bench_session& s, std::size_t threads)
+{
+    fan_out(s, "6.2/pool/fan_out/std_async", [] (std::vector<double>&& d)
+    { return std::async(std::launch::async, summing(std::move(d))); });
+    {
+        Global_queue_pool pool{threads};
+        fan_out(s, "6.2/pool/fan_out/global_queue", [&pool] (std::vector<double>&& d)
+        { return pool.submit(summing(std::move(d))); });
+    }
+    {
+        em::Thread_pool pool{threads};
+        fan_out(s, "6.2/pool/fan_out/work_stealing", [&pool] (std::vector<double>&& d)
+        { return pool.submit(summing(std::move(d))); });
+    }
+}
+
+//------------------------------------------------------------------------------
+// Рекурсивное разбиение: задачи порождают задачи внутри пула.
+// Пулу с общей очередью и блокирующим get() это грозит взаимной
+// блокировкой, а em::Thread_pool выполняет чужие задачи в get()
+
+double split_sum(em::Thread_pool& pool, const double* p, std::size_t n)
+{
+    if (n <= 1024) return std::accumulate(p, p + n, 0.0);
+    auto half = n / 2;
+    auto left = pool.submit([&pool, p, half] { return split_sum(pool, p, half); });
+    auto right = split_sum(pool, p + half, n - half);
+    return left.get() + right;
+}
+
+void recursive_suite(em::Bench_session& s, std::size_t threads)
+{
+    std::vector<double> data(std::size_t{1} << 22, 0.25);
+    em::Thread_pool pool{threads};
+    double sum = 0;
+    auto* r = s.run("6.2/pool/recursive/work_stealing", [&]
+    {
+        sum = pool.submit([&] { return split_sum(pool, data.data(), data.size()); }).get();
+    });
+    if (!r) return;
+    r->counter("Mvalues/s", data.size() * 1e3 / r->median.count());
+    if (sum != data.size() * 0.25)
+        std::cerr << "6.2/pool/recursive: неверная сумма " << sum << '\n';
+}
+
+//------------------------------------------------------------------------------
+// Цепочка продолжений: then() против ожидания и повторной постановки
+
+void continuation_suite(em::Bench_session& s, std::size_t threads)
+{
+    constexpr int chain_length = 256;
+    em::Thread_pool pool{threads};
+    int result = chain_length;          // Не меняется, если прогоны отфильтрованы
+
+    if (auto* r = s.run("6.2/pool/chain/get_submit", [&]
+        {
+            int x = 0;
+            for (int i = 0; i < chain_length; ++i)
+                x = pool.submit([x] { return x + 1; }).get();
+            result = x;
+        }))
+        r->counter("ns/link", r->median.count() / double(chain_length));
+
+    if (auto* r = s.run("6.2/pool/chain/then", [&]
+        {
+            auto f = pool.submit([] { return 0; });
+            for (int i = 0; i < chain_length; ++i)
+                f = f.then([] (int x) { return x + 1; });
+            result = f.get();
+        }))
+        r->counter("ns/link", r->median.count() / double(chain_length));
+
+    if (result != chain_length)
+        std::cerr << "6.2/pool/chain: результат " << result << '\n';
+}
+
+em::Bench_registrar pool_suite{"6.2/pool", [] (em::Bench_session& s)
+{
+    auto threads = std::max(1u, std::thread::hardware_concurrency());
+    fan_out_suite(s, threads);
+    recursive_suite(s, threads);
+    continuation_suite(s, threads);
+}};
+
+} // namespace
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,141 @@
+//------------------------------------------------------------------------------
+
+// Бенчмарки к разделу 6.4: between_l и between_b по одному значению
+// против Range_predicate над столбцом
+
+//------------------------------------------------------------------------------
+
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "Benchmark.hpp"
+#include "Range_scan.hpp"
+
+//------------------------------------------------------------------------------
+
+namespace {
+
+constexpr std::size_t value_count = 1 << 20;
+
+template<class T>
+std::vector<T> make_values()
+{
+    std::mt19937_64 gen{42};
+    std::vector<T> v(value_count);
+    for (auto& x : v) x = T(gen() % 1000);
+    return v;
+}
+
+void add_throughput(em::Bench_result* r)
+{
+    if (r) r->counter("Mvalues/s", value_count * 1e3 / r->median.count());
+}
+
+// Отбор поэлементным предикатом, как с between_l в книге
+template<class T, class Pred>
+void select_each(const std::vector<T>& values, Pred pred, em::Bitmask& out)
+{
+    out.resize(values.size());
+    for (std::size_t i = 0; i < values.size(); ++i)
+        out.set(i, pred(values[i]));
+}
+
+template<class T>
+void run_levels(em::Bench_session& s, const std::string& prefix,
+                const em::Range_predicate<T>& pred,
+                const std::vector<T>& values, const em::Bitmask& expected)
+{
+    em::Bitmask out;
+    const auto top = em::simd_level();
+    for (auto level : {em::Simd_level::scalar, em::Simd_level::sse4,
+                       em::Simd_level::avx2}) {
+        if (top < level) break;
+        em::set_simd_limit(level);
+
+        auto name = prefix + em::to_string(level);
+        if (pred.select(values) != expected)
+            std::cerr << name << ": отбор не совпал с поэлементным\n";
+        add_throughput(s.run(name, [&]
+        {
+            pred.select(values, out);
+            em::do_not_optimize(out);
+        }));
+    }
+    em::set_simd_limit(em::Simd_level::avx2);
+}
+
+template<class T>
+void run_between(em::Bench_session& s, const std::string& type)
+{
+    using namespace std::placeholders;
+
+    auto values = make_values<T>();
+    T low_val(100);
+    T high_val(500);
+    em::do_not_optimize(low_val);
+    em::do_not_optimize(high_val);
+    auto prefix = "6.4/between/" + type + "/";
+
+    auto between_l =
+            [low_val, high_val]
+            (const auto& val)
+            { return low_val <= val && val <= high_val; };
+    auto between_b =
+            std::bind(std::logical_and<>(),
+                      std::bind(std::less_equal<>(), low_val, _1),
+                      std::bind(std::less_equal<>(), _1, high_val));
+
+    em::Bitmask expected;
+    select_each(values, between_l, expected);
+
+    em::Bitmask out;
+    add_throughput(s.run(prefix + "lambda", [&]
+    {
+        select_each(values, between_l, out);
+        em::do_not_optimize(out);
+    }));
+    add_throughput(s.run(prefix + "bind", [&]
+    {
+        select_each(values, between_b, out);
+        em::do_not_optimize(out);
+    }));
+
+    run_levels(s, prefix, em::Range_predicate<T>::between(low_val, high_val),
+               values, expected);
+}
+
+// IN-список и NOT BETWEEN
+void run_combined(em::Bench_session& s)
+{
+    auto values = make_values<int>();
+    em::Bitmask expected;
+
+    auto in = em::Range_predicate<int>::in({3, 17, 42, 256, 257, 258, 999});
+    select_each(values, [] (int v)
+    {
+        return v == 3 || v == 17 || v == 42 || v == 256 || v == 257
+               || v == 258 || v == 999;
+    }, expected);
+    run_levels(s, "6.4/in_list/int/", in, values, expected);
+
+    auto not_between = em::Range_predicate<int>::not_between(100, 500);
+    select_each(values, [] (int v) { return !(100 <= v && v <= 500); },
+                expected);
+    run_levels(s, "6.4/not_between/int/", not_between, values, expected);
+}
+
+em::Bench_registrar range_suite{"6.4", [] (em::Bench_session& s)
+{
+    run_between<int>(s, "int");
+    run_between<std::int64_t>(s, "int64");
+    run_between<float>(s, "float");
+    run_between<double>(s, "double");
+    run_combined(s);
+}};
+
+} // namespace
+
+//------------------------------------------------------------------------------
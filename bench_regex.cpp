@@ -0,0 +1,125 @@
+//------------------------------------------------------------------------------
+
+// Бенчмарки к разделу 8.2: проверка строк журнала набором шаблонов -
+// std::vector<std::regex> по очереди против одного em::Regex_set
+
+//------------------------------------------------------------------------------
+
+#include <iostream>
+#include <random>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Benchmark.hpp"
+#include "Regex_set.hpp"
+
+//------------------------------------------------------------------------------
+
+namespace {
+
+constexpr std::size_t line_count = 4096;
+constexpr std::size_t chunk_size = 4096;
+
+const char* const patterns[] = {
+    "[A-Z]+",                                   // upper_case_word из 8.2
+    "ERROR",
+    "timeout after [0-9]+ ?ms",
+    "user=[a-z]+@[a-z]+\\.com",
+    "(GET|POST|PUT) /api/v[0-9]+/[a-z/]+",
+    "status=5[0-9][0-9]",
+    "^\\[[0-9]{4}-[0-9]{2}-[0-9]{2}",
+    "latency=[0-9]{4,}ms$",
+};
+constexpr std::size_t pattern_count = std::size(patterns);
+
+std::vector<std::string> make_log()
+{
+    std::mt19937_64 gen{42};
+    const char* levels[] = {"info", "debug", "warn", "ERROR"};
+    const char* methods[] = {"GET", "POST", "PUT", "DELETE"};
+    const char* users[] = {"alice", "bob", "carol", "dave"};
+
+    std::vector<std::string> lines;
+    for (std::size_t i = 0; i < line_count; ++i) {
+        std::string line;
+        if (gen() % 2) line += "[2024-05-" + std::to_string(10 + gen() % 20) + " 12:00:00] ";
+        line += levels[gen() % 4];
+        line += " request ";
+        line += methods[gen() % 4];
+        line += " /api/v" + std::to_string(gen() % 3) + "/widgets/list";
+        line += " user=" + std::string{users[gen() % 4]} + "@example.com";
+        line += " status=" + std::to_string(200 + gen() % 400);
+        if (gen() % 8 == 0) line += " timeout after " + std::to_string(gen() % 5000) + "ms";
+        line += " latency=" + std::to_string(gen() % 20000) + "ms";
+        lines.push_back(std::move(line));
+    }
+    return lines;
+}
+
+void add_throughput(em::Bench_result* r, std::size_t bytes)
+{
+    if (r) r->counter("MB/s", bytes * 1e3 / r->median.count());
+}
+
+em::Bench_registrar regex_suite{"8.2/regex_set", [] (em::Bench_session& s)
+{
+    const auto lines = make_log();
+    std::size_t bytes = 0;
+    for (const auto& l : lines) bytes += l.size();
+
+    // Совпадения по строкам: hits[p] - число строк, где совпал шаблон p
+    using Hits = std::vector<std::size_t>;
+
+    std::vector<std::regex> regexes;
+    for (auto p : patterns) regexes.emplace_back(p);
+    Hits expected(pattern_count);
+    add_throughput(s.run("8.2/regex_set/lines/std_regex", [&]
+    {
+        Hits hits(pattern_count);
+        for (const auto& l : lines)
+            for (std::size_t p = 0; p < pattern_count; ++p)
+                hits[p] += std::regex_search(l, regexes[p]);
+        expected = hits;
+        em::do_not_optimize(expected);
+    }), bytes);
+
+    em::Regex_set set;
+    for (auto p : patterns) set.add(p);
+    Hits got(pattern_count);
+    add_throughput(s.run("8.2/regex_set/lines/dfa", [&]
+    {
+        Hits hits(pattern_count);
+        auto scanner = set.scanner();
+        for (const auto& l : lines) {
+            scanner.feed(l);
+            for (auto p : scanner.finish()) ++hits[p];
+        }
+        got = hits;
+        em::do_not_optimize(got);
+    }), bytes);
+    if (expected[0] && got[0] && got != expected)
+        std::cerr << "8.2/regex_set/lines: совпадения em::Regex_set и std::regex различны\n";
+
+    // Весь журнал фрагментами: какие шаблоны встречаются в нем хотя бы раз
+    std::string log;
+    for (const auto& l : lines) {
+        if (!log.empty()) log += '\n';
+        log += l;
+    }
+    std::vector<std::size_t> found;
+    add_throughput(s.run("8.2/regex_set/stream/dfa", [&]
+    {
+        auto scanner = set.scanner();
+        for (std::size_t i = 0; i < log.size(); i += chunk_size)
+            scanner.feed(std::string_view{log}.substr(i, chunk_size));
+        found = scanner.finish();
+        em::do_not_optimize(found);
+    }), log.size());
+    if (!found.empty() && found != set.match(log))
+        std::cerr << "8.2/regex_set/stream: результат зависит от разбиения на фрагменты\n";
+}};
+
+} // namespace
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,96 @@
+//------------------------------------------------------------------------------
+
+// Бенчмарки к разделу 4.3: fast_load_widget из книги против Weak_cache
+
+//------------------------------------------------------------------------------
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include "Benchmark.hpp"
+#include "Weak_cache.hpp"
+
+//------------------------------------------------------------------------------
+
+namespace {
+
+using Widget_id = unsigned;
+
+struct Widget {
+    Widget_id id;
+    int payload[16]{};
+};
+
+std::unique_ptr<const Widget> load_widget(Widget_id id)
+{
+    return std::make_unique<const Widget>(Widget{id});
+}
+
+// Версия из книги (без синхронизации, пригодна только для одного потока)
+std::unordered_map<Widget_id, std::weak_ptr<const Widget>> book_cache;
+
+std::shared_ptr<const Widget> book_fast_load_widget(Widget_id id)
+{
+    auto obj_ptr = book_cache[id].lock();
+    if (!obj_ptr) {
+        obj_ptr = load_widget(id);
+        book_cache[id] = obj_ptr;
+    }
+    return obj_ptr;
+}
+
+// Счетчики кэша в результат бенчмарка
+template<class Cache>
+void add_metrics(em::Bench_result* r, const Cache& cache)
+{
+    if (!r) return;
+    auto mt = cache.metrics();
+    auto total = mt.hits + mt.misses;
+    r->counter("hit_rate", total ? double(mt.hits) / total : 0.0);
+    r->counter("size", mt.size);
+    r->counter("hot_size", mt.hot_size);
+    r->counter("swept", mt.swept);
+}
+
+constexpr Widget_id hot_set = 1024;         // Рабочее множество
+
+em::Bench_registrar weak_cache_suite{"4.3", [] (em::Bench_session& s)
+{
+    // Поток новых id, объекты сразу отпускаются: все записи просрочены.
+    // В книжной версии карта растет без ограничений
+    Widget_id next_id = 0;
+    if (auto* r = s.run("4.3/churn/book", [&next_id] {
+            return book_fast_load_widget(next_id++)->id;
+        }))
+        r->counter("size", book_cache.size());
+    book_cache = {};
+
+    {
+        em::Weak_cache<Widget_id, Widget> cache;
+        next_id = 0;
+        add_metrics(s.run("4.3/churn/weak_cache", [&] {
+            return cache.get(next_id++, load_widget)->id;
+        }), cache);
+    }
+
+    // Повторные обращения к рабочему множеству; без горячего уровня
+    // каждое обращение - повторная загрузка
+    for (std::size_t hot : {std::size_t{0}, std::size_t{hot_set}}) {
+        em::Weak_cache<Widget_id, Widget> cache{{16, hot, 2}};
+        auto name = "4.3/working_set/hot:" + std::to_string(hot);
+        int hw = static_cast<int>(std::thread::hardware_concurrency());
+        for (int t = 1; t <= (hw > 1 ? hw : 2); t *= 2)
+            add_metrics(s.run_threaded(
+                            name + "/threads:" + std::to_string(t), t,
+                            [&cache] (std::size_t tid) {
+                thread_local unsigned i = 0;    // Свой счетчик у каждого потока
+                auto id = static_cast<Widget_id>((i++ * 7 + tid) % hot_set);
+                return cache.get(id, load_widget)->id;
+            }), cache);
+    }
+}};
+
+} // namespace
+
+//------------------------------------------------------------------------------
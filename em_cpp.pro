@@ -18,4 +18,68 @@ HEADERS += \
     Chapter1.hpp \
     Chapter4.hpp \
     Chapter5.hpp \
-    Chapter8.hpp
+    Chapter8.hpp \
+    Benchmark.hpp \
+    Alloc_counter.hpp \
+    Async_log.hpp \
+    Polynomial.hpp \
+    Lazy.hpp \
+    Sharded_counter.hpp \
+    Weak_cache.hpp \
+    Slab_pool.hpp \
+    Investment.hpp \
+    Intrusive_ptr.hpp \
+    Simd.hpp \
+    Bitmask.hpp \
+    Divisibility.hpp \
+    Filter_engine.hpp \
+    Range_scan.hpp \
+    Timing_wheel.hpp \
+    Alarm_service.hpp \
+    Compression.hpp \
+    Unique_function.hpp \
+    Thread_pool.hpp \
+    Task.hpp \
+    Event_loop.hpp \
+    Flag_store.hpp \
+    Normalize.hpp \
+    Name_store.hpp \
+    Hive.hpp \
+    Regex_set.hpp \
+    Concurrent_multiset.hpp \
+    Name_dictionary.hpp
+
+# Микробенчмарки собираются отдельной целью: make bench
+BENCH_SOURCES = \
+        $$PWD/bench.cpp \
+        $$PWD/bench_emplace.cpp \
+        $$PWD/bench_alloc.cpp \
+        $$PWD/bench_log.cpp \
+        $$PWD/bench_polynomial.cpp \
+        $$PWD/bench_lazy.cpp \
+        $$PWD/bench_counter.cpp \
+        $$PWD/bench_weak_cache.cpp \
+        $$PWD/bench_investment.cpp \
+        $$PWD/bench_intrusive.cpp \
+        $$PWD/bench_filter.cpp \
+        $$PWD/bench_divisible.cpp \
+        $$PWD/bench_range.cpp \
+        $$PWD/bench_alarm.cpp \
+        $$PWD/bench_compress.cpp \
+        $$PWD/bench_function.cpp \
+        $$PWD/bench_pool.cpp \
+        $$PWD/bench_coro.cpp \
+        $$PWD/bench_flags.cpp \
+        $$PWD/bench_normalize.cpp \
+        $$PWD/bench_names.cpp \
+        $$PWD/bench_hive.cpp \
+        $$PWD/bench_regex.cpp \
+        $$PWD/bench_multiset.cpp \
+        $$PWD/bench_dictionary.cpp
+
+bench.target = bench
+bench.depends = $$BENCH_SOURCES
+bench.commands = $(MKDIR) $$DESTDIR && \
+        $$QMAKE_CXX $$QMAKE_CXXFLAGS -O2 -pthread -I$$PWD \
+        $$BENCH_SOURCES -o $$DESTDIR/bench
+QMAKE_EXTRA_TARGETS += bench